@@ -59,6 +59,12 @@ FString FArticyGVar::GetCPPTypeString() const
 	case EArticyType::ADT_String:
 		return TEXT("UArticyString");
 
+	case EArticyType::ADT_Float:
+		return TEXT("UArticyFloat");
+
+	case EArticyType::ADT_Enum:
+		return TEXT("UArticyEnum");
+
 	default:
 		return TEXT("Cannot get CPP type string, unknown type!");
 	}
@@ -81,6 +87,15 @@ FString FArticyGVar::GetCPPValueString() const
 		value = FString::Printf(TEXT("\"%s\""), *StringValue);
 		break;
 
+	case EArticyType::ADT_Float:
+		value = FString::SanitizeFloat(FloatValue) + TEXT("f");
+		break;
+
+	case EArticyType::ADT_Enum:
+		// enums are initialized with the index of their default value
+		value = FString::Printf(TEXT("%d"), IntValue);
+		break;
+
 	default:
 		value = TEXT("Cannot get CPP init string, unknown type!");
 	}
@@ -103,6 +118,10 @@ void FArticyGVar::ImportFromJson(const TSharedPtr<FJsonObject> JsonVar)
 			Type = EArticyType::ADT_Boolean;
 		else if (typeString == TEXT("Integer"))
 			Type = EArticyType::ADT_Integer;
+		else if (typeString == TEXT("Float"))
+			Type = EArticyType::ADT_Float;
+		else if (typeString == TEXT("Enum"))
+			Type = EArticyType::ADT_Enum;
 		else
 		{
 			if (typeString != TEXT("String"))
@@ -121,10 +140,70 @@ void FArticyGVar::ImportFromJson(const TSharedPtr<FJsonObject> JsonVar)
 		break;
 	case EArticyType::ADT_String: JsonVar->TryGetStringField(TEXT("Value"), StringValue);
 		break;
+	case EArticyType::ADT_Float:
+		{
+			double value = 0;
+			if (JsonVar->TryGetNumberField(TEXT("Value"), value))
+				FloatValue = static_cast<float>(value);
+		}
+		break;
+	case EArticyType::ADT_Enum:
+		{
+			JsonVar->TryGetStringField(TEXT("Value"), StringValue);
+			const TArray<TSharedPtr<FJsonValue>>* valuesJson;
+			if (JsonVar->TryGetArrayField(TEXT("Values"), valuesJson))
+			{
+				for (const auto valueJson : *valuesJson)
+					EnumValues.Add(valueJson->AsString());
+			}
+			IntValue = EnumValues.AddUnique(StringValue);
+		}
+		break;
 	default: break;
 	}
 }
 
+void FArticyGVar::ApplyTypeOverride(const FString& Namespace)
+{
+	const FString fullName = Namespace + TEXT(".") + Variable;
+	const auto typeOverride = UArticyPluginSettings::Get()->GlobalVariableTypeOverrides.FindByPredicate([&fullName](const FArticyGlobalVariableTypeOverride& Override)
+	{
+		return Override.Variable == fullName;
+	});
+
+	if (!typeOverride)
+		return;
+
+	switch (typeOverride->Storage)
+	{
+	case EArticyGlobalVariableStorage::Float:
+		if (Type == EArticyType::ADT_Integer)
+			FloatValue = IntValue;
+		else if (Type == EArticyType::ADT_String)
+			LexFromString(FloatValue, *StringValue);
+		else
+		{
+			UE_LOG(LogArticyEditor, Error, TEXT("Global variable %s cannot be stored as float, only integer and string variables can."), *fullName);
+			return;
+		}
+
+		Type = EArticyType::ADT_Float;
+		break;
+
+	case EArticyGlobalVariableStorage::Enum:
+		if (Type != EArticyType::ADT_String)
+		{
+			UE_LOG(LogArticyEditor, Error, TEXT("Global variable %s cannot be stored as enum, only string variables can."), *fullName);
+			return;
+		}
+
+		EnumValues = typeOverride->EnumValues;
+		IntValue = EnumValues.AddUnique(StringValue);
+		Type = EArticyType::ADT_Enum;
+		break;
+	}
+}
+
 void FArticyGVNamespace::ImportFromJson(const TSharedPtr<FJsonObject> JsonNamespace, const UArticyImportData* Data)
 {
 	if (!JsonNamespace.IsValid())
@@ -145,6 +224,7 @@ void FArticyGVNamespace::ImportFromJson(const TSharedPtr<FJsonObject> JsonNamesp
 
 		FArticyGVar var;
 		var.ImportFromJson(obj);
+		var.ApplyTypeOverride(Namespace);
 		Variables.Add(var);
 	}
 }
@@ -443,7 +523,9 @@ void UArticyImportData::ImportFromJson(const TSharedPtr<FJsonObject> RootObject)
 		bNeedsCodeGeneration = true;
 	}
 
-	if (Settings.DidScriptFragmentsChange() && this->GetSettings().set_UseScriptSupport)
+	// enum literals in the scripts depend on the global variables, so they must be gathered again if those changed
+	const bool bEnumsChanged = Settings.DidObjectDefsOrGVsChange() && HasEnumVariables();
+	if ((Settings.DidScriptFragmentsChange() || bEnumsChanged) && this->GetSettings().set_UseScriptSupport)
 	{
 		this->GatherScripts();
 		bNeedsCodeGeneration = true;
@@ -573,8 +655,116 @@ TArray<UArticyPackage*> UArticyImportData::GetPackagesDirect()
 
 void UArticyImportData::GatherScripts()
 {
+	EnumVariableValues.Reset();
+	StringVariables.Reset();
+	for (const auto& ns : GlobalVariables.Namespaces)
+	{
+		for (const auto& var : ns.Variables)
+		{
+			if (var.Type == EArticyType::ADT_Enum)
+				EnumVariableValues.Add(ns.Namespace + TEXT(".") + var.Variable, var.EnumValues);
+			else if (var.Type == EArticyType::ADT_String)
+				StringVariables.Add(ns.Namespace + TEXT(".") + var.Variable);
+		}
+	}
+
 	ScriptFragments.Empty();
 	PackageDefs.GatherScripts(this);
+
+	EnumVariableValues.Reset();
+	StringVariables.Reset();
+}
+
+bool UArticyImportData::HasEnumVariables() const
+{
+	for (const auto& ns : GlobalVariables.Namespaces)
+	{
+		for (const auto& var : ns.Variables)
+		{
+			if (var.Type == EArticyType::ADT_Enum)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+/** The patterns used by ReplaceEnumLiterals, built once per script fragment. */
+struct FEnumLiteralPatterns
+{
+	FEnumLiteralPatterns()
+		// Namespace.Variable followed by a comparison or assignment and a literal string, or a literal string compared with Namespace.Variable
+		: VariableFirst(TEXT("(?<![\"a-zA-Z_])([a-zA-Z_]\\w*\\.\\w+)\\s*(?:==|!=|=)\\s*(\"(?:[^\"\\\\]|\\\\.)*\")"))
+		, LiteralFirst(TEXT("(\"(?:[^\"\\\\]|\\\\.)*\")\\s*(?:==|!=)\\s*([a-zA-Z_]\\w*\\.\\w+)"))
+	{
+	}
+
+	const FRegexPattern VariableFirst;
+	const FRegexPattern LiteralFirst;
+};
+
+/**
+ * Replaces string literals which are assigned to or compared with an enum variable by the index of the value,
+ * so the generated code compares integers. Unknown values are import errors, the literal is kept and never matches.
+ * Text inside string literals is never replaced.
+ */
+static FString ReplaceEnumLiterals(const FString& Line, const TMap<FString, TArray<FString>>& EnumVariableValues,
+                                   const FEnumLiteralPatterns& Patterns, const FRegexPattern& LiteralStringPattern)
+{
+	if (EnumVariableValues.Num() == 0)
+		return Line;
+
+	FString result = Line;
+	auto replaceLiterals = [&](const FRegexPattern& Pattern, const int32 VariableGroup, const int32 LiteralGroup)
+	{
+		// the string literals of the line, matches are only replaced if their variable is outside of all of them
+		TArray<TPair<int32, int32>> quotedSpans;
+		FRegexMatcher literalStrings(LiteralStringPattern, result);
+		while (literalStrings.FindNext())
+			quotedSpans.Emplace(literalStrings.GetMatchBeginning(), literalStrings.GetMatchEnding());
+
+		auto isQuoted = [&quotedSpans](const int32 Position)
+		{
+			return quotedSpans.ContainsByPredicate([Position](const TPair<int32, int32>& Span) { return Position > Span.Key && Position < Span.Value; });
+		};
+		auto isLiteral = [&quotedSpans](const int32 Position)
+		{
+			return quotedSpans.ContainsByPredicate([Position](const TPair<int32, int32>& Span) { return Position == Span.Key; });
+		};
+
+		FRegexMatcher matcher(Pattern, result);
+		FString replaced;
+		int32 copiedUntil = 0;
+		while (matcher.FindNext())
+		{
+			if (isQuoted(matcher.GetCaptureGroupBeginning(VariableGroup)) || !isLiteral(matcher.GetCaptureGroupBeginning(LiteralGroup)))
+				continue;
+
+			const FString variable = matcher.GetCaptureGroup(VariableGroup);
+			const auto values = EnumVariableValues.Find(variable);
+			if (!values)
+				continue;
+
+			const FString literal = matcher.GetCaptureGroup(LiteralGroup);
+			const int32 index = values->IndexOfByKey(literal.Mid(1, literal.Len() - 2));
+			if (index == INDEX_NONE)
+			{
+				UE_LOG(LogArticyEditor, Error, TEXT("%s is not a value of the enum variable %s."), *literal, *variable);
+				continue;
+			}
+
+			const int32 literalStart = matcher.GetCaptureGroupBeginning(LiteralGroup);
+			replaced += result.Mid(copiedUntil, literalStart - copiedUntil) + FString::FromInt(index);
+			copiedUntil = matcher.GetCaptureGroupEnding(LiteralGroup);
+		}
+
+		result = replaced + result.Mid(copiedUntil);
+	};
+
+	replaceLiterals(Patterns.VariableFirst, 1, 2);
+	replaceLiterals(Patterns.LiteralFirst, 2, 1);
+
+	return result;
 }
 
 void UArticyImportData::AddScriptFragment(const FString& Fragment, const bool bIsInstruction)
@@ -588,6 +778,7 @@ void UArticyImportData::AddScriptFragment(const FString& Fragment, const bool bI
 
 	// regex pattern to find literal string, even if they contain escaped quotes (looks nasty if string escaped...): "([^"\\]|\\[\s\S])*" 
 	const FRegexPattern literalStringPattern(TEXT("\"([^\"\\\\]|\\\\[\\s\\S])*\""));
+	const FEnumLiteralPatterns enumLiteralPatterns;
 
 	bool bCreateBlueprintableUserMethods = UArticyPluginSettings::Get()->bCreateBlueprintTypeForScriptMethods;
 
@@ -627,7 +818,7 @@ void UArticyImportData::AddScriptFragment(const FString& Fragment, const bool bI
 		string = comments;
 		for (auto l = 0; l < lines.Num(); ++l)
 		{
-			auto line = lines[l];
+			auto line = ReplaceEnumLiterals(lines[l], EnumVariableValues, enumLiteralPatterns, literalStringPattern);
 
 			// since "line" gets modified after the literalStrings matcher was created
 			// we need to offset the values from the matcher based on the changes done to "line" in the loop
@@ -654,6 +845,15 @@ void UArticyImportData::AddScriptFragment(const FString& Fragment, const bool bI
 			while (assignments.FindNext())
 				lastAssignment = assignments.GetMatchBeginning();
 
+			//the variable assigned to, enum variables on the right are converted depending on its type
+			FString target;
+			FRegexMatcher targetAccess(unquotedWordDotWord, line);
+			while (targetAccess.FindNext() && targetAccess.GetMatchEnding() <= lastAssignment)
+				target = targetAccess.GetCaptureGroup(1);
+
+			const auto targetEnumValues = EnumVariableValues.Find(target);
+			const bool bTargetIsString = StringVariables.Contains(target);
+
 			offset = 0;
 
 			//replace all remaining Namespace.Variable with *Namespace->Variable
@@ -682,7 +882,20 @@ void UArticyImportData::AddScriptFragment(const FString& Fragment, const bool bI
 				if (!inLiteral)
 				{
 					// only to GV replacement if we are not within a literal string
-					if (lastAssignment < start)
+					const FString variable = line.Mid(start, end - start);
+					const auto enumValues = EnumVariableValues.Find(variable);
+					if (lastAssignment < start && enumValues && !(targetEnumValues && *targetEnumValues == *enumValues))
+					{
+						//the index of an enum means nothing to a string or an enum with other values, so these get its name
+						//otherwise the variable itself is used, so comparisons with names use the name overloads
+						FString replacement = TEXT("(*") + variable.Replace(TEXT("."), TEXT("->")) + TEXT(")");
+						if (targetEnumValues || bTargetIsString)
+							replacement += TEXT(".GetValueName().ToString()");
+
+						line = line.Left(start) + replacement + line.Mid(end);
+						offset += replacement.Len() - variable.Len();
+					}
+					else if (lastAssignment < start)
 					{
 						//there is an assignment operator to the left of this, thus get the raw value
 						line = line.Left(start) + line.Mid(start, end - start).Replace(TEXT("."), TEXT("->")) +
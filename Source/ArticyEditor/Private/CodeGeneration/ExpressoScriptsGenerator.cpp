@@ -6,6 +6,8 @@
 #include "ExpressoScriptsGenerator.h"
 #include "CodeFileGenerator.h"
 #include "ArticyPluginSettings.h"
+#include "ArticyHelpers.h"
+#include "Internationalization/Regex.h"
 
 void GenerateMethodInterface(CodeFileGenerator* header, const UArticyImportData* Data, bool bCreateBlueprintableUserMethods)
 {
@@ -58,6 +60,13 @@ void GenerateUserMethods(CodeFileGenerator* header, const UArticyImportData* Dat
 
 			if(bCreateBlueprintableUserMethods)
 			{
+				//native providers are called directly, only blueprint providers need to go through Execute_
+				header->Line(FString::Printf(TEXT("if(auto nativeProvider = static_cast<%s*>(GetNativeUserMethodsProvider(methodProvider, true)))"), *iClass));
+				if(bIsVoid)
+					header->Line(FString::Printf(TEXT("{ nativeProvider->%s_Implementation(%s); return; }"), *method.BlueprintName, *method.GetArguments()), false, true, 1);
+				else
+					header->Line(FString::Printf(TEXT("return nativeProvider->%s_Implementation(%s);"), *method.BlueprintName, *method.GetArguments()), false, true, 1);
+
 				FString args = "";
 				if(method.ArgumentList.Num() != 0)
 				{
@@ -66,12 +75,99 @@ void GenerateUserMethods(CodeFileGenerator* header, const UArticyImportData* Dat
 				header->Line(FString::Printf(TEXT("%s%s::Execute_%s(methodProvider%s);"), *returnOrEmpty, *iClass, *method.BlueprintName, *args));
 			}
 			else
-				header->Line(FString::Printf(TEXT("%sCast<%s>(methodProvider)->%s(%s);"), *returnOrEmpty, *iClass, *method.Name, *method.GetArguments()));
+			{
+				header->Line(FString::Printf(TEXT("auto nativeProvider = static_cast<%s*>(GetNativeUserMethodsProvider(methodProvider, false));"), *iClass));
+				header->Line(FString::Printf(TEXT("if(!nativeProvider) return %s;"), *method.GetCPPDefaultReturn()));
+				header->Line(FString::Printf(TEXT("%snativeProvider->%s(%s);"), *returnOrEmpty, *method.Name, *method.GetArguments()));
+			}
 
 		}, "", false, "", "const");
 	}
 }
 
+/**
+ * Replaces getObj calls with a literal id or name (and optional literal clone id) by getObj(ObjectHandles[i]).
+ * Handles are shared by all calls with the same arguments, their constructor arguments are added to Handles.
+ */
+FString ReplaceObjectLiterals(const FString& Fragment, TMap<FString, int32>& HandleIndices, TArray<FString>& Handles)
+{
+	//literal strings were already wrapped in FString(TEXT(...)) when the fragment was parsed
+	const FRegexPattern literalGetObj(TEXT("getObj\\(\\s*FString\\(TEXT\\(\"([^\"\\\\]*)\"\\)\\)\\s*(?:,\\s*(\\d+)\\s*)?\\)"));
+
+	FString result;
+	int32 last = 0;
+	FRegexMatcher matcher(literalGetObj, Fragment);
+	while (matcher.FindNext())
+	{
+		const FString nameOrId = matcher.GetCaptureGroup(1);
+		const FString cloneId = matcher.GetCaptureGroup(2).IsEmpty() ? TEXT("0") : matcher.GetCaptureGroup(2);
+		if (nameOrId.IsEmpty())
+			continue;
+
+		const FString key = nameOrId + TEXT("_") + cloneId;
+		int32 index;
+		if (const int32* existing = HandleIndices.Find(key))
+		{
+			index = *existing;
+		}
+		else
+		{
+			//parse the id here, like getObj would do at runtime
+			FString handle;
+			if (nameOrId.StartsWith(TEXT("0x")))
+				handle = FString::Printf(TEXT("FArticyId(%lluull), %s"), ArticyHelpers::HexToUint64(nameOrId), *cloneId);
+			else if (nameOrId.IsNumeric())
+				handle = FString::Printf(TEXT("FArticyId(%lluull), %s"), FCString::Strtoui64(*nameOrId, nullptr, 10), *cloneId);
+			else
+				handle = FString::Printf(TEXT("FName(TEXT(\"%s\")), %s"), *nameOrId, *cloneId);
+
+			index = Handles.Add(handle);
+			HandleIndices.Add(key, index);
+		}
+
+		result += Fragment.Mid(last, matcher.GetMatchBeginning() - last);
+		result += FString::Printf(TEXT("getObj(ObjectHandles[%d])"), index);
+		last = matcher.GetMatchEnding();
+	}
+
+	return result + Fragment.Mid(last);
+}
+
+/**
+ * Replaces the remaining literal strings by StringLiterals[i], so they are created once instead of on every evaluation.
+ * Equal literals share an entry, the literals are added to Literals.
+ */
+FString ReplaceStringLiterals(const FString& Fragment, TMap<FString, int32>& LiteralIndices, TArray<FString>& Literals)
+{
+	//literal strings were already wrapped in FString(TEXT(...)) when the fragment was parsed
+	const FRegexPattern wrappedLiteral(TEXT("FString\\(TEXT\\((\"(?:[^\"\\\\]|\\\\[\\s\\S])*\")\\)\\)"));
+
+	FString result;
+	int32 last = 0;
+	FRegexMatcher matcher(wrappedLiteral, Fragment);
+	while (matcher.FindNext())
+	{
+		const FString literal = matcher.GetCaptureGroup(1);
+
+		int32 index;
+		if (const int32* existing = LiteralIndices.Find(literal))
+		{
+			index = *existing;
+		}
+		else
+		{
+			index = Literals.Add(literal);
+			LiteralIndices.Add(literal, index);
+		}
+
+		result += Fragment.Mid(last, matcher.GetMatchBeginning() - last);
+		result += FString::Printf(TEXT("StringLiterals[%d]"), index);
+		last = matcher.GetMatchEnding();
+	}
+
+	return result + Fragment.Mid(last);
+}
+
 void GenerateExpressoScripts(CodeFileGenerator* header, const UArticyImportData* Data)
 {
 	header->Line("private:", false, true, -1);
@@ -128,7 +224,36 @@ void GenerateExpressoScripts(CodeFileGenerator* header, const UArticyImportData*
 	header->Line("#endif");
 	header->Method("", CodeGenerator::GetExpressoScriptsClassname(Data), "", [&]
 	{
-		const auto fragments = Data->GetScriptFragments();
+		auto fragments = Data->GetScriptFragments();
+
+		//resolve literal getObj calls via cached handles
+		TMap<FString, int32> handleIndices;
+		TArray<FString> handles;
+		for(auto& script : fragments)
+			script.ParsedFragment = ReplaceObjectLiterals(script.ParsedFragment, handleIndices, handles);
+
+		if(handles.Num() > 0)
+		{
+			header->Line(FString::Printf(TEXT("ObjectHandles.Reserve(%d);"), handles.Num()));
+			for(const auto& handle : handles)
+				header->Line(FString::Printf(TEXT("ObjectHandles.Emplace(%s);"), *handle));
+			header->Line();
+		}
+
+		//create string literals once, and share their strings with the script values made from them
+		TMap<FString, int32> literalIndices;
+		TArray<FString> literals;
+		for(auto& script : fragments)
+			script.ParsedFragment = ReplaceStringLiterals(script.ParsedFragment, literalIndices, literals);
+
+		if(literals.Num() > 0)
+		{
+			header->Line(FString::Printf(TEXT("StringLiterals.Reserve(%d);"), literals.Num()));
+			for(const auto& literal : literals)
+				header->Line(FString::Printf(TEXT("StringLiterals.Emplace(TEXT(%s));"), *literal));
+			header->Line();
+		}
+
 		for(auto script : fragments)
 		{
 			if(script.OriginalFragment.IsEmpty())
@@ -62,6 +62,15 @@ void GlobalVarsGenerator::GenerateCode(const UArticyImportData* Data)
 
 					for(const auto var : ns.Variables)
 					{
+						if(var.Type == EArticyType::ADT_Enum)
+						{
+							//the value names must be known before the (index) value is set
+							TArray<FString> names;
+							for(const auto& value : var.EnumValues)
+								names.Add(FString::Printf(TEXT("FName(TEXT(\"%s\"))"), *value.ReplaceCharWithEscapedChar()));
+							header->Line(FString::Printf(TEXT("%s->SetValueNames({ %s });"), *var.Variable, *FString::Join(names, TEXT(", "))));
+						}
+
 						header->Line(FString::Printf(TEXT("%s->Init<%s>(this, Store, TEXT(\"%s.%s\"), %s);"), *var.Variable, *var.GetCPPTypeString(), *ns.Namespace, *var.Variable, *var.GetCPPValueString()));
 						header->Line(FString::Printf(TEXT("this->Variables.Add(%s);"), *var.Variable));
 					}					
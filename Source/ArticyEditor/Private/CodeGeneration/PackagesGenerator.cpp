@@ -4,14 +4,17 @@
 
 #include "PackagesGenerator.h"
 #include "ArticyImportData.h"
+#include "TextsGenerator.h"
 
 #define LOCTEXT_NAMESPACE "PackagesGenerator"
 
 void PackagesGenerator::GenerateAssets(UArticyImportData* Data)
 {
-	// generate new articy objects
+	// generate new articy objects, collecting their texts in the string table if enabled
+	TextsGenerator::BeginAsset();
 	const auto ArticyPackageDefs = Data->GetPackageDefs();
 	ArticyPackageDefs.GenerateAssets(Data);
+	TextsGenerator::EndAsset();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,44 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "TextsGenerator.h"
+#include "Internationalization/StringTable.h"
+#include "Internationalization/StringTableCore.h"
+#include "ArticyImporterHelpers.h"
+#include "ArticyPluginSettings.h"
+
+UStringTable* TextsGenerator::StringTable = nullptr;
+
+void TextsGenerator::BeginAsset()
+{
+	StringTable = nullptr;
+	if (!GetDefault<UArticyPluginSettings>()->bExportTextsToStringTable)
+		return;
+
+	StringTable = ArticyImporterHelpers::GenerateAsset<UStringTable>(TEXT("StringTable"), TEXT("Engine"), TEXT("ArticyTexts"));
+	if (!ensureMsgf(StringTable, TEXT("Could not create the ArticyTexts string table, the texts are stored in the objects instead.")))
+		return;
+
+	// the same namespace as texts stored in the objects, so their keys are identical
+	auto table = StringTable->GetMutableStringTable();
+	table->ClearSourceStrings();
+	table->SetNamespace(TEXT("ARTICY"));
+}
+
+void TextsGenerator::EndAsset()
+{
+	if (StringTable)
+		StringTable->MarkPackageDirty();
+
+	StringTable = nullptr;
+}
+
+FText TextsGenerator::MakeText(const FString& Key, const FString& SourceString)
+{
+	if (!StringTable)
+		return FText::ChangeKey(TEXT("ARTICY"), Key, FText::FromString(SourceString));
+
+	StringTable->GetMutableStringTable()->SetSourceString(Key, SourceString);
+	return FText::FromStringTable(StringTable->GetStringTableId(), Key);
+}
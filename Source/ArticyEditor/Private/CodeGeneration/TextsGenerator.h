@@ -0,0 +1,28 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UStringTable;
+
+/**
+ * Collects the localized texts of the imported objects into the string table asset ArticyTexts,
+ * while the package assets are generated. The objects then only reference their texts by key.
+ */
+class TextsGenerator
+{
+public:
+
+	/** Creates the string table asset if the plugin settings ask for it. Texts are collected until EndAsset is called. */
+	static void BeginAsset();
+	static void EndAsset();
+
+	/** Returns the text to store in an object: a reference into the string table while it is generated, otherwise the text itself. */
+	static FText MakeText(const FString& Key, const FString& SourceString);
+
+private:
+
+	static UStringTable* StringTable;
+};
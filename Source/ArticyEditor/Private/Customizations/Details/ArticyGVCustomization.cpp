@@ -9,6 +9,7 @@
 #include "Delegates/Delegate.h"
 #include "ArticyEditorModule.h"
 #include "Widgets/Layout/SSplitter.h"
+#include "Widgets/Layout/SBox.h"
 #include "Slate/GV/SArticyGlobalVariablesDebugger.h"
 #include "Runtime/Launch/Resources/Version.h"
 
@@ -44,7 +45,12 @@ void FArticyGVCustomization::CustomizeDetails(IDetailLayoutBuilder& DetailBuilde
 	FDetailWidgetRow& Row = CategoryBuilder.AddCustomRow(FText::FromString(TEXT("Articy")));
 	Row.WholeRowWidget
 	[
-		SNew(SArticyGlobalVariables, GV).bInitiallyCollapsed(true)
+		// the variables are displayed in a list view, which needs a bounded height inside the details panel
+		SNew(SBox)
+		.MaxDesiredHeight(600.f)
+		[
+			SNew(SArticyGlobalVariables, GV).bInitiallyCollapsed(true)
+		]
 	];
 
 	//// retrieve the propertyhandles for the properties in the class (which are variablesets), and create widgets for them
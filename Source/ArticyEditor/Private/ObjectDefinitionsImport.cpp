@@ -12,6 +12,7 @@
 #include "ArticyFlowClasses.h"
 #include "ArticyScriptFragment.h"
 #include "ArticyEntity.h"
+#include "ArticyAsset.h"
 #include "UObject/ConstructorHelpers.h"
 
 //---------------------------------------------------------------------------//
@@ -208,6 +209,9 @@ void FArticyObjectDef::InitializeModel(UArticyPrimitive* Model, const FArticyMod
 		const auto Category = FName{ TEXT("Category") };
 		Model->SetProp(AssetRef, Vals.GetAssetRef());
 		Model->SetProp(Category, Vals.GetAssetCat());
+
+		if (auto asset = Cast<UArticyAsset>(Model))
+			asset->UpdateAssetPath();
 	}
 
 	const auto nameAndId = Vals.GetNameAndId();
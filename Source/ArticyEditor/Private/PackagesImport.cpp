@@ -8,6 +8,7 @@
 #include "ArticyImportData.h"
 #include "CodeGeneration/CodeGenerator.h"
 #include "ArticyObject.h"
+#include "ArticyAsset.h"
 #include "Policies/CondensedJsonPrintPolicy.h"
 #include "Serialization/JsonSerializer.h"
 #include "Serialization/JsonWriter.h"
@@ -293,6 +294,39 @@ void FArticyPackageDefs::GenerateAssets(UArticyImportData* Data) const
 			}
 		}
 	}
+
+	//gather the media each package references for its asset bundle, the referenced articy assets may be in any package
+	TMap<FArticyId, UArticyObject*> objectsById;
+	for (auto pack : ArticyPackages)
+	{
+		for (auto obj : pack->GetAssets())
+			objectsById.Add(obj->GetId(), obj);
+	}
+
+	const auto resolve = [&objectsById](const FArticyId& Id) -> UArticyObject*
+	{
+		auto obj = objectsById.Find(Id);
+		return obj ? *obj : nullptr;
+	};
+
+	for (auto pack : ArticyPackages)
+	{
+		TArray<UArticyAsset*> mediaAssets;
+		for (auto obj : pack->GetAssets())
+		{
+			if (auto asset = Cast<UArticyAsset>(obj))
+				mediaAssets.AddUnique(asset);
+			UArticyAsset::GetReferencedAssets(obj, mediaAssets, resolve);
+		}
+
+		TArray<FSoftObjectPath> mediaPaths;
+		for (auto asset : mediaAssets)
+		{
+			if (!asset->GetAssetPath().IsNull())
+				mediaPaths.AddUnique(asset->GetAssetPath());
+		}
+		pack->SetMediaAssets(mediaPaths);
+	}
 }
 
 TSet<FString> FArticyPackageDefs::GetPackageNames() const
@@ -8,6 +8,8 @@
 #include "ArticyObject.h"
 #include "ArticyBuiltinTypes.h"
 #include "ArticyScriptFragment.h"
+#include "ArticyMarkup.h"
+#include "CodeGeneration/TextsGenerator.h"
 
 #define STRINGIFY(x) #x
 
@@ -55,7 +57,8 @@ FArticyPredefTypes::FArticyPredefTypes()
 				Json->AsString();
 
 			//return a new FText, where the Path is the key and the Property value is the defaut-language text
-			return FText::ChangeKey(TEXT("ARTICY"), Path, FText::FromString(Processed));
+			//(stored in the string table, if the texts are exported to it)
+			return TextsGenerator::MakeText(Path, Processed);
 		}
 		return FText::GetEmpty();
 	}));
@@ -162,6 +165,12 @@ struct TagInfo
 	TagInfo(const FString& name, const FString& val) 
 		: tagName(name), hasValue(val.Len() > 0), value(val), dummy(false) { 
 		if (tagName == TEXT("align")) { dummy = true; }
+
+		// Resolve articy hyperlinks now, so the runtime doesn't have to parse them
+		FArticyId linkTarget;
+		if (hasValue && ArticyMarkup::ParseLinkTarget(value, linkTarget)) {
+			linkId = FString::Printf(TEXT("%llu"), linkTarget.Get());
+		}
 	}
 
 	// Tag name, like b, i, u, or color
@@ -175,6 +184,9 @@ struct TagInfo
 
 	// Dummy. Ignore this in the output
 	bool dummy;
+
+	// Id of the target, if the value is an articy hyperlink
+	FString linkId;
 };
 
 bool HasAnyTags(const TArray<TagInfo>& currentTags)
@@ -201,6 +213,9 @@ FString CreateOpenTag(const TArray<TagInfo>& currentTags)
 		// If it's a value, append to the value string
 		if (tag.hasValue) {
 			valueString = valueString + FString::Printf(TEXT(" %s=\"%s\""), *tag.tagName, *tag.value);
+			if (tag.linkId.Len() > 0) {
+				valueString = valueString + FString::Printf(TEXT(" %s=\"%s\""), ArticyMarkup::LinkIdMetaData, *tag.linkId);
+			}
 		}
 		else {
 			// Otherwise, add the tag to the list
@@ -225,47 +240,41 @@ FString CreateOpenTag(const TArray<TagInfo>& currentTags)
 
 FString ConvertUnityMarkupToUnreal(const FString& Input)
 {
-	// Create a pattern to find closing tags
-	static FRegexPattern Pattern(TEXT("<\\/.+?>|<(\\w+)(=\"?(.+?)\"?)?>"));
+	FArticyMarkupTokenizer tokenizer(Input);
+	FArticyMarkupToken token;
 
-	// Create a matcher to search the input
-	FRegexMatcher myMatcher(Pattern, Input);
-
-	// Check to see if there's any matches at all
-	bool anyMatches = myMatcher.FindNext();
+	// Find the first tag, so text without markup is returned without copying it
+	int32 firstTagStart = INDEX_NONE;
+	while (tokenizer.Next(token))
+	{
+		if (token.IsTag())
+		{
+			firstTagStart = token.Start;
+			break;
+		}
+	}
 
-	// If not, just return the input string
-	if (!anyMatches) { return Input; }
+	// If there is none, just return the input string
+	if (firstTagStart == INDEX_NONE) { return Input; }
 
-	// Create a buffer to hold the output
-	FString strings = "";
-	/*
-	// Future TODO: I wanted to use string builder for efficiency, but it's not available in older versions of Unreal
-	//  or, at least, it gave me some build errors
-	TCHAR* buffer = new TCHAR[Input.Len() * 2];
-	FStringBuilderBase strings(buffer, Input.Len() * 2);
-	*/
+	FString strings;
+	strings.Reserve(Input.Len() + Input.Len() / 4);
+	strings.AppendChars(*Input, firstTagStart);
 
-	// Run through matches
+	// Run through the tokens, starting with the first tag
 	TArray<TagInfo> currentTags;
-	int last = 0;
 	do
 	{
-		// Get bounds of match
-		int start = myMatcher.GetMatchBeginning();
-		int end = myMatcher.GetMatchEnding();
-
-		// Add all text preceding the match to the output
-		strings += (Input.Mid(last, start - last));
-
-		// Check if we're dealing with a start tag or an end tag
-		FString tagName = myMatcher.GetCaptureGroup(1);
-		if (tagName.Len() > 0) {
+		if (!token.IsTag())
+		{
+			strings.AppendChars(*Input + token.Start, token.Length);
+		}
+		else if (token.Type == EArticyMarkupTokenType::OpenTag)
+		{
 			bool hasTagsToClose = HasAnyTags(currentTags);
 
 			// Add to our list
-			FString value = myMatcher.GetCaptureGroup(3);
-			TagInfo info = TagInfo(tagName, value);
+			TagInfo info = TagInfo(token.Name, token.Value);
 			currentTags.Add(info);
 
 			// Don't bother if this is a dummy tag we're ignoring
@@ -278,7 +287,8 @@ FString ConvertUnityMarkupToUnreal(const FString& Input)
 				strings += (CreateOpenTag(currentTags));
 			}
 		}
-		else {
+		else if (currentTags.Num() > 0)
+		{
 			// Remove our last tag
 			auto popped = currentTags.Pop();
 
@@ -295,26 +305,7 @@ FString ConvertUnityMarkupToUnreal(const FString& Input)
 				}
 			}
 		}
+	} while (tokenizer.Next(token));
 
-		last = end;
-
-		
-	} while (myMatcher.FindNext());
-
-	// Add end of string
-	if (last != Input.Len())
-	{
-		strings += (Input.Mid(last, Input.Len() - last));
-	}
-
-	// Create string
-	FString result = strings;//.ToString();
-
-	// Clean memory
-	// TODO - see above about old unreal vers
-	//delete buffer;
-	//buffer = nullptr;
-
-	// Return result
-	return result;
-}
\ No newline at end of file
+	return strings;
+}
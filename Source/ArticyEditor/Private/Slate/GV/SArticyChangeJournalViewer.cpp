@@ -0,0 +1,303 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "Slate/GV/SArticyChangeJournalViewer.h"
+#include "ArticyPluginSettings.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Views/STableRow.h"
+
+#define LOCTEXT_NAMESPACE "ArticyChangeJournal"
+
+namespace ArticyChangeJournalColumns
+{
+	static const FName Sequence("Sequence");
+	static const FName Frame("Frame");
+	static const FName Target("Target");
+	static const FName OldValue("OldValue");
+	static const FName NewValue("NewValue");
+	static const FName Context("Context");
+	static const FName Rewind("Rewind");
+}
+
+/** A single row of the journal, all text is formatted when the row is generated (i.e. scrolled into view) */
+class SArticyChangeJournalRow : public SMultiColumnTableRow<FArticyJournalEntryPtr>
+{
+public:
+	SLATE_BEGIN_ARGS(SArticyChangeJournalRow) {}
+		SLATE_ARGUMENT(TWeakPtr<const FArticyChangeJournal>, Journal)
+		SLATE_EVENT(FOnClicked, OnRewind)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& Args, const TSharedRef<STableViewBase>& OwnerTable, FArticyJournalEntryPtr InEntry)
+	{
+		Entry = InEntry;
+		Journal = Args._Journal;
+		OnRewind = Args._OnRewind;
+		SMultiColumnTableRow<FArticyJournalEntryPtr>::Construct(FSuperRowType::FArguments(), OwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		if (ColumnName == ArticyChangeJournalColumns::Rewind)
+		{
+			return SNew(SButton)
+				.Text(LOCTEXT("RewindButton", "Rewind"))
+				.ToolTipText(LOCTEXT("RewindButtonTooltip", "Undo all changes which happened after this one."))
+				.OnClicked(OnRewind);
+		}
+
+		return SNew(STextBlock).Text(GetColumnText(ColumnName));
+	}
+
+private:
+	FText GetColumnText(const FName& ColumnName) const
+	{
+		if (ColumnName == ArticyChangeJournalColumns::Sequence)
+		{
+			return FText::AsNumber(Entry->Sequence);
+		}
+		if (ColumnName == ArticyChangeJournalColumns::Frame)
+		{
+			return FText::AsNumber(Entry->Frame);
+		}
+		if (ColumnName == ArticyChangeJournalColumns::Target)
+		{
+			UObject* Target = Entry->Target.Get();
+			if (!Target)
+			{
+				return LOCTEXT("DestroyedTarget", "<destroyed>");
+			}
+			if (Entry->IsVariableChange())
+			{
+				const UArticyVariable* Variable = Cast<UArticyVariable>(Target);
+				return FText::FromName(Variable ? Variable->GetGVName() : Target->GetFName());
+			}
+			return FText::FromString(FString::Printf(TEXT("%s.%s"), *Target->GetName(), *Entry->Property.ToString()));
+		}
+		if (ColumnName == ArticyChangeJournalColumns::OldValue)
+		{
+			const TSharedPtr<const FArticyChangeJournal> PinnedJournal = Journal.Pin();
+			return FText::FromString(PinnedJournal.IsValid() ? PinnedJournal->ValueToString(Entry->OldValue) : FString());
+		}
+		if (ColumnName == ArticyChangeJournalColumns::NewValue)
+		{
+			const TSharedPtr<const FArticyChangeJournal> PinnedJournal = Journal.Pin();
+			return FText::FromString(PinnedJournal.IsValid() ? PinnedJournal->ValueToString(Entry->NewValue) : FString());
+		}
+		if (ColumnName == ArticyChangeJournalColumns::Context)
+		{
+			if (Entry->FragmentHash == 0)
+			{
+				return LOCTEXT("NoScriptContext", "Code / Blueprint");
+			}
+
+			const FString Self = Entry->Self.IsValid() ? Entry->Self->GetName() : TEXT("-");
+			const FString Speaker = Entry->Speaker.IsValid() ? Entry->Speaker->GetName() : TEXT("-");
+			return FText::FromString(FString::Printf(TEXT("Fragment %08X, self: %s, speaker: %s"), static_cast<uint32>(Entry->FragmentHash), *Self, *Speaker));
+		}
+
+		return FText::GetEmpty();
+	}
+
+	FArticyJournalEntryPtr Entry;
+	TWeakPtr<const FArticyChangeJournal> Journal;
+	FOnClicked OnRewind;
+};
+
+//---------------------------------------------------------------------------//
+
+void SArticyChangeJournalViewer::Construct(const FArguments& Args)
+{
+	SAssignNew(ListView, SListView<FArticyJournalEntryPtr>)
+	.ListItemsSource(&Entries)
+	.OnGenerateRow(this, &SArticyChangeJournalViewer::OnGenerateRow)
+	.SelectionMode(ESelectionMode::Single)
+	.HeaderRow
+	(
+		SNew(SHeaderRow)
+		+ SHeaderRow::Column(ArticyChangeJournalColumns::Sequence).DefaultLabel(LOCTEXT("SequenceColumn", "#")).FixedWidth(60.f)
+		+ SHeaderRow::Column(ArticyChangeJournalColumns::Frame).DefaultLabel(LOCTEXT("FrameColumn", "Frame")).FixedWidth(70.f)
+		+ SHeaderRow::Column(ArticyChangeJournalColumns::Target).DefaultLabel(LOCTEXT("TargetColumn", "Variable / Property")).FillWidth(0.3f)
+		+ SHeaderRow::Column(ArticyChangeJournalColumns::OldValue).DefaultLabel(LOCTEXT("OldValueColumn", "Old Value")).FillWidth(0.15f)
+		+ SHeaderRow::Column(ArticyChangeJournalColumns::NewValue).DefaultLabel(LOCTEXT("NewValueColumn", "New Value")).FillWidth(0.15f)
+		+ SHeaderRow::Column(ArticyChangeJournalColumns::Context).DefaultLabel(LOCTEXT("ContextColumn", "Context")).FillWidth(0.4f)
+		+ SHeaderRow::Column(ArticyChangeJournalColumns::Rewind).DefaultLabel(FText::GetEmpty()).FixedWidth(70.f)
+	);
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5.f)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			[
+				SNew(SCheckBox)
+				.IsChecked(this, &SArticyChangeJournalViewer::IsJournalEnabled)
+				.OnCheckStateChanged(this, &SArticyChangeJournalViewer::OnJournalEnabledChanged)
+				[
+					SNew(STextBlock).Text(LOCTEXT("RecordJournal", "Record changes"))
+				]
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(10.f, 0.f)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("ClearJournal", "Clear"))
+				.OnClicked(this, &SArticyChangeJournalViewer::OnClearClicked)
+			]
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock).Text(this, &SArticyChangeJournalViewer::GetStatusText)
+			]
+		]
+		+ SVerticalBox::Slot()
+		.FillHeight(1.f)
+		[
+			ListView.ToSharedRef()
+		]
+	];
+}
+
+void SArticyChangeJournalViewer::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+	RefreshEntries();
+}
+
+void SArticyChangeJournalViewer::SetGlobalVariables(TWeakObjectPtr<UArticyGlobalVariables> InGV)
+{
+	GlobalVariables = InGV;
+	RefreshEntries(true);
+}
+
+TSharedRef<ITableRow> SArticyChangeJournalViewer::OnGenerateRow(FArticyJournalEntryPtr Entry, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SArticyChangeJournalRow, OwnerTable, Entry)
+		.Journal(DisplayedJournal)
+		.OnRewind(FOnClicked::CreateSP(this, &SArticyChangeJournalViewer::OnRewindClicked, Entry->Sequence));
+}
+
+void SArticyChangeJournalViewer::RefreshEntries(bool bForce)
+{
+	const TSharedPtr<FArticyChangeJournal> Journal = GetJournal();
+	bool bChanged = false;
+
+	// a different journal, or entries removed by a rewind or reset, require copying all entries again
+	if (bForce || Journal != DisplayedJournal.Pin() || (Journal.IsValid() && Journal->GetGeneration() != DisplayedGeneration))
+	{
+		DisplayedJournal = Journal;
+		DisplayedSequence = 0;
+		DisplayedGeneration = Journal.IsValid() ? Journal->GetGeneration() : 0;
+		Entries.Reset();
+		bChanged = true;
+	}
+
+	if (Journal.IsValid())
+	{
+		const int32 Num = Journal->Num();
+
+		// drop the oldest entries once the journal overwrote them, their pooled strings may be gone
+		const uint32 OldestSequence = Num > 0 ? Journal->GetEntry(0).Sequence : Journal->GetLatestSequence() + 1;
+		while (Entries.Num() > 0 && Entries.Last()->Sequence < OldestSequence)
+		{
+			Entries.Pop();
+			bChanged = true;
+		}
+
+		// the sequence numbers in the journal are consecutive, so the new entries are the last ones
+		const uint32 LatestSequence = Journal->GetLatestSequence();
+		if (LatestSequence > DisplayedSequence)
+		{
+			const int32 NumNew = static_cast<int32>(FMath::Min<uint32>(LatestSequence - DisplayedSequence, Num));
+
+			TArray<FArticyJournalEntryPtr> NewEntries;
+			NewEntries.Reserve(NumNew);
+			for (int32 i = Num - 1; i >= Num - NumNew; --i)
+			{
+				NewEntries.Add(MakeShared<FArticyJournalEntry>(Journal->GetEntry(i)));
+			}
+
+			// newest first
+			Entries.Insert(NewEntries, 0);
+			DisplayedSequence = LatestSequence;
+			bChanged = true;
+		}
+	}
+
+	if (bChanged)
+	{
+		ListView->RequestListRefresh();
+	}
+}
+
+TSharedPtr<FArticyChangeJournal> SArticyChangeJournalViewer::GetJournal() const
+{
+	return GlobalVariables.IsValid() ? GlobalVariables->GetSharedChangeJournal() : nullptr;
+}
+
+FText SArticyChangeJournalViewer::GetStatusText() const
+{
+	const TSharedPtr<FArticyChangeJournal> Journal = GetJournal();
+	if (!Journal.IsValid())
+	{
+		return LOCTEXT("JournalDisabled", "The change journal is not recording.");
+	}
+
+	return FText::Format(LOCTEXT("JournalStatus", "{0} of {1} entries"), FText::AsNumber(Journal->Num()), FText::AsNumber(Journal->GetCapacity()));
+}
+
+ECheckBoxState SArticyChangeJournalViewer::IsJournalEnabled() const
+{
+	return GetJournal().IsValid() ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void SArticyChangeJournalViewer::OnJournalEnabledChanged(ECheckBoxState NewState)
+{
+	if (!GlobalVariables.IsValid())
+	{
+		return;
+	}
+
+	if (NewState == ECheckBoxState::Checked)
+	{
+		GlobalVariables->EnableChangeJournal(GetDefault<UArticyPluginSettings>()->ChangeJournalCapacity);
+	}
+	else
+	{
+		GlobalVariables->DisableChangeJournal();
+	}
+}
+
+FReply SArticyChangeJournalViewer::OnClearClicked()
+{
+	if (const TSharedPtr<FArticyChangeJournal> Journal = GetJournal())
+	{
+		Journal->Reset();
+	}
+
+	return FReply::Handled();
+}
+
+FReply SArticyChangeJournalViewer::OnRewindClicked(uint32 Sequence)
+{
+	if (GlobalVariables.IsValid())
+	{
+		GlobalVariables->RewindChangeJournal(static_cast<int32>(Sequence));
+	}
+
+	return FReply::Handled();
+}
+
+#undef LOCTEXT_NAMESPACE
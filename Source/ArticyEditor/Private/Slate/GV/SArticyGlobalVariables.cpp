@@ -8,7 +8,11 @@
 #include "Widgets/Input/SNumericEntryBox.h"
 #include "Widgets/Input/SSearchBox.h"
 #include "Widgets/Input/SCheckBox.h"
-#include "Widgets/Layout/SScrollBox.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SComboButton.h"
+#include "Framework/MultiBox/MultiBoxBuilder.h"
+#include "Widgets/Images/SImage.h"
+#include "Widgets/Layout/SBorder.h"
 #include "Widgets/Layout/SBox.h"
 #include "Editor.h"
 #include "ScopedTransaction.h"
@@ -23,91 +27,205 @@ using SplitterSlotType = SSplitter::FSlot&;
 using HorizontalBoxSlotType = SHorizontalBox::FSlot&;
 #endif
 
-void SArticyVariableSet::Construct(const FArguments& Args, TWeakObjectPtr<UArticyBaseVariableSet> InVariableSet)
+namespace ArticyGlobalVariablesWidget
 {
-	VariableSet = InVariableSet;
+	/** How long (in seconds) a changed value stays highlighted */
+	constexpr double ChangeHighlightDuration = 1.5;
+}
 
-	ensure(VariableSet.IsValid());
-	
-	SizeData = Args._SizeData;
+SArticyGlobalVariables::~SArticyGlobalVariables()
+{
+	UnbindFromGlobalVariables();
+}
 
-	VariableContainer = SNew(SVerticalBox);
+void SArticyGlobalVariables::Construct(const FArguments& Args, TWeakObjectPtr<UArticyGlobalVariables> GV)
+{
+	SizeData.RightColumnWidth = TAttribute<float>(this, &SArticyGlobalVariables::OnGetRightColumnWidth);
+	SizeData.LeftColumnWidth = TAttribute<float>(this, &SArticyGlobalVariables::OnGetLeftColumnWidth);
+	SizeData.OnWidthChanged = SSplitter::FOnSlotResized::CreateSP(this, &SArticyGlobalVariables::OnSetColumnWidth);
+
+	bInitiallyCollapsed = Args._bInitiallyCollapsed;
+
+	// only the rows which are scrolled into view get widgets, and their value cells pull the current value when painted
+	SAssignNew(ListView, SListView<FArticyGVListItemPtr>)
+	.ListItemsSource(&DisplayedItems)
+	.OnGenerateRow(this, &SArticyGlobalVariables::OnGenerateRow)
+	.SelectionMode(ESelectionMode::None);
+
+	UpdateDisplayedGlobalVariables(GV);
+
+	TSharedRef<SSearchBox> SearchBox = SNew(SSearchBox)
+		.OnTextChanged(this, &SArticyGlobalVariables::OnSearchBoxChanged)
+		.OnTextCommitted(this, &SArticyGlobalVariables::OnSearchBoxCommitted)
+		.DelayChangeNotificationsWhileTyping(true);
 
-	NamespaceExpansion = SNew(SExpandableArea)
-	.InitiallyCollapsed(Args._bInitiallyCollapsed)
-	.BorderBackgroundColor(FLinearColor(0.7f, 0.7f, 0.7f))
-	.HeaderContent()
+	ChildSlot
 	[
-		SNew(SHorizontalBox)
-		+ SHorizontalBox::Slot()
-		.FillWidth(1.f)
+		SNew(SVerticalBox)
+		+ SVerticalBox::Slot()
+		.AutoHeight()
 		[
-			SNew(STextBlock)
-			.Text(FText::FromString(VariableSet->GetName()))
-			.TextStyle(FArticyEditorStyle::Get(), TEXT("ArticyImporter.GlobalVariables.Namespace"))
+			SearchBox
+		]
+		+ SVerticalBox::Slot()
+		.FillHeight(1.f)
+		[
+			ListView.ToSharedRef()
 		]
-	]
-	.BodyContent()
-	[
-		VariableContainer.ToSharedRef()
 	];
+}
 
-	BuildVariableWidgets();
+void SArticyGlobalVariables::UpdateDisplayedGlobalVariables(TWeakObjectPtr<UArticyGlobalVariables> InGV)
+{
+	UnbindFromGlobalVariables();
 
-	ChildSlot
-	[
-		NamespaceExpansion.ToSharedRef()
-	];
+	GlobalVariables = InGV;
+	AllItems.Reset();
+	ItemsByVariable.Reset();
+
+	if(GlobalVariables.IsValid())
+	{
+		TArray<UArticyBaseVariableSet*> SortedSets = GlobalVariables->GetVariableSets();
+		SortedSets.Sort([](const UArticyBaseVariableSet& LHS, const UArticyBaseVariableSet& RHS)
+		{
+			return LHS.GetName().Compare(RHS.GetName(), ESearchCase::IgnoreCase) < 0;
+		});
+
+		for (UArticyBaseVariableSet* Set : SortedSets)
+		{
+			const FString SetName = Set->GetName();
+
+			FArticyGVListItemPtr SetItem = MakeShareable(new FArticyGVListItem);
+			SetItem->Set = Set;
+			SetItem->DisplayName = SetName;
+			SetItem->SearchKey = SetName.ToLower();
+			SetItem->bExpanded = !bInitiallyCollapsed;
+			const int32 SetIndex = AllItems.Add(SetItem);
+
+			TArray<UArticyVariable*> SortedVars = Set->Variables;
+			SortedVars.Sort([](const UArticyVariable& LHS, const UArticyVariable& RHS)
+			{
+				return LHS.GetName().Compare(RHS.GetName(), ESearchCase::IgnoreCase) < 0;
+			});
+
+			for (UArticyVariable* Var : SortedVars)
+			{
+				FArticyGVListItemPtr VarItem = MakeShareable(new FArticyGVListItem);
+				VarItem->Set = Set;
+				VarItem->Variable = Var;
+				VarItem->DisplayName = Var->GetName();
+				VarItem->SearchKey = FString::Printf(TEXT("%s.%s"), *SetName, *Var->GetName()).ToLower();
+				VarItem->NamespaceIndex = SetIndex;
+				AllItems.Add(VarItem);
+				ItemsByVariable.Add(Var, VarItem);
+			}
+		}
+	}
+
+	BindToGlobalVariables();
+
+	// the rows changed, so the previous result can't be reused
+	UpdateMatchingItems(false);
 }
 
-void SArticyVariableSet::SetExpanded(bool bInExpanded) const
+TSharedRef<ITableRow> SArticyGlobalVariables::OnGenerateRow(FArticyGVListItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable)
 {
-	NamespaceExpansion->SetExpanded(bInExpanded);
+	return SNew(STableRow<FArticyGVListItemPtr>, OwnerTable)
+	[
+		Item->IsNamespace() ? MakeNamespaceWidget(Item) : MakeVariableWidget(Item)
+	];
 }
 
-bool SArticyVariableSet::IsExpanded() const
+TSharedRef<SWidget> SArticyGlobalVariables::MakeNamespaceWidget(FArticyGVListItemPtr Item)
 {
-	return NamespaceExpansion->IsExpanded();
+	return SNew(SButton)
+	.ButtonStyle(FCoreStyle::Get(), "NoBorder")
+#if __cplusplus >= 202002L
+	.OnClicked_Lambda([=, this]()
+#else
+	.OnClicked_Lambda([=]()
+#endif
+	{
+		Item->bExpanded = !Item->bExpanded;
+		RefreshDisplayedItems();
+		return FReply::Handled();
+	})
+	[
+		SNew(SHorizontalBox)
+		+ SHorizontalBox::Slot()
+		.AutoWidth()
+		.VAlign(VAlign_Center)
+		.Padding(2.f, 0.f, 5.f, 0.f)
+		[
+			SNew(SImage)
+#if __cplusplus >= 202002L
+			.Image_Lambda([=, this]()
+#else
+			.Image_Lambda([=]()
+#endif
+			{
+				const bool bShowExpanded = Item->bExpanded || SearchTerms.Num() > 0;
+				return FCoreStyle::Get().GetBrush(bShowExpanded ? "TreeArrow_Expanded" : "TreeArrow_Collapsed");
+			})
+		]
+		+ SHorizontalBox::Slot()
+		.FillWidth(1.f)
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(Item->DisplayName))
+			.TextStyle(FArticyEditorStyle::Get(), TEXT("ArticyImporter.GlobalVariables.Namespace"))
+		]
+	];
 }
 
-void SArticyVariableSet::BuildVariableWidgets()
+TSharedRef<SWidget> SArticyGlobalVariables::MakeVariableWidget(FArticyGVListItemPtr Item)
 {
-	if (bVariableWidgetsBuilt)
+	UArticyVariable* Var = Item->Variable.Get();
+	if (!Var)
 	{
-		return;
+		return SNullWidget::NullWidget;
 	}
 
-	TArray<UArticyVariable*> SortedVars = VariableSet->Variables;
-	SortedVars.Sort([](const UArticyVariable& LHS, const UArticyVariable& RHS)
-	{
-		return LHS.GetName().Compare(RHS.GetName(), ESearchCase::IgnoreCase) < 0 ? true : false;
-	});
-	
-	for (UArticyVariable* Var : SortedVars)
-	{
-		TSharedRef<SSplitter> LocalSplitter = SNew(SSplitter);
+	TSharedRef<SSplitter> LocalSplitter = SNew(SSplitter);
 
-		// left variable slot
-		LocalSplitter->AddSlot()
-		.Value(SizeData->LeftColumnWidth)
-		.OnSlotResized(SizeData->OnWidthChanged)
-		[
-			SNew(STextBlock).Text_Lambda([Var]()
-			{
-				return FText::FromString(Var->GetName());
-			})
-		];
+	// left variable slot
+	LocalSplitter->AddSlot()
+	.Value(SizeData.LeftColumnWidth)
+	.OnSlotResized(SizeData.OnWidthChanged)
+	[
+		SNew(STextBlock).Text(FText::FromString(Item->DisplayName))
+	];
 
-		// right variable slot
-		SplitterSlotType RightVariableSlot = LocalSplitter->AddSlot();
-		RightVariableSlot.Value(SizeData->RightColumnWidth);
-		RightVariableSlot.OnSlotResized(SizeData->OnWidthChanged);
+	// right variable slot
+	SplitterSlotType RightVariableSlot = LocalSplitter->AddSlot();
+	RightVariableSlot.Value(SizeData.RightColumnWidth);
+	RightVariableSlot.OnSlotResized(SizeData.OnWidthChanged);
 
-		TSharedRef<SHorizontalBox> ConstrainBox = SNew(SHorizontalBox);
-		HorizontalBoxSlotType InnerVarSlot = ConstrainBox->AddSlot();
-		InnerVarSlot.AutoWidth();
+	TSharedRef<SHorizontalBox> ConstrainBox = SNew(SHorizontalBox);
+	HorizontalBoxSlotType InnerVarSlot = ConstrainBox->AddSlot();
+	InnerVarSlot.AutoWidth();
+	InnerVarSlot
+	[
+		MakeValueWidget(Var)
+	];
 
-		RightVariableSlot
+	RightVariableSlot
+	[
+		SNew(SBorder)
+		.BorderImage(FCoreStyle::Get().GetBrush("GenericWhiteBox"))
+		.Padding(0.f)
+		// fade out a highlight after the value changed at runtime
+		.BorderBackgroundColor_Lambda([Item]()
+		{
+			const double Age = FPlatformTime::Seconds() - Item->LastChangeTime;
+			if (Item->LastChangeTime < 0.0 || Age > ArticyGlobalVariablesWidget::ChangeHighlightDuration)
+			{
+				return FSlateColor(FLinearColor::Transparent);
+			}
+
+			const float Alpha = 0.4f * (1.f - static_cast<float>(Age / ArticyGlobalVariablesWidget::ChangeHighlightDuration));
+			return FSlateColor(FLinearColor(1.f, 0.75f, 0.f, Alpha));
+		})
 		[
 			SNew(SBox)
 			.MinDesiredWidth(150.f)
@@ -115,316 +233,301 @@ void SArticyVariableSet::BuildVariableWidgets()
 			[
 				ConstrainBox
 			]
-		];
+		]
+	];
 
-		if (Var->GetClass() == UArticyString::StaticClass())
-		{
-			UArticyString* StringVar = Cast<UArticyString>(Var);
-			InnerVarSlot
-			[
-				SNew(SEditableTextBox)
-				.MinDesiredWidth(30.f)
-				.Text_Lambda([StringVar]()
-				{
-					return FText::FromString(StringVar->Get());
-				})
-				.OnTextCommitted_Lambda([StringVar](const FText& Text, ETextCommit::Type CommitType)
-				{
-					if(StringVar->Get().Equals(Text.ToString()))
-					{
-						return;
-					}
+	return SNew(SBox)
+	.Padding(FMargin(25.f, 5.f, 5.f, 5.f))
+	[
+		LocalSplitter
+	];
+}
 
-					const FScopedTransaction Transaction(LOCTEXT("ModifyGV", "Modified GV"));
-					StringVar->Modify();
-					*StringVar = Text.ToString();
-				})
-			];
-		}
-		else if (Var->GetClass() == UArticyInt::StaticClass())
+TSharedRef<SWidget> SArticyGlobalVariables::MakeValueWidget(UArticyVariable* Var)
+{
+	if (Var->GetClass() == UArticyString::StaticClass())
+	{
+		UArticyString* StringVar = Cast<UArticyString>(Var);
+		return SNew(SEditableTextBox)
+		.MinDesiredWidth(30.f)
+		.Text_Lambda([StringVar]()
 		{
-			UArticyInt* IntVar = Cast<UArticyInt>(Var);
-			InnerVarSlot
-			[
-				SNew(SNumericEntryBox<int32>)
-				.AllowSpin(true)
-				.MaxSliderValue(TOptional<int32>())
-				.MinSliderValue(TOptional<int32>())
-				.MinDesiredValueWidth(80.f)
+			return FText::FromString(StringVar->Get());
+		})
+		.OnTextCommitted_Lambda([StringVar](const FText& Text, ETextCommit::Type CommitType)
+		{
+			if(StringVar->Get().Equals(Text.ToString()))
+			{
+				return;
+			}
+
+			const FScopedTransaction Transaction(LOCTEXT("ModifyGV", "Modified GV"));
+			StringVar->Modify();
+			*StringVar = Text.ToString();
+		});
+	}
+
+	if (Var->GetClass() == UArticyInt::StaticClass())
+	{
+		UArticyInt* IntVar = Cast<UArticyInt>(Var);
+		return SNew(SNumericEntryBox<int32>)
+		.AllowSpin(true)
+		.MaxSliderValue(TOptional<int32>())
+		.MinSliderValue(TOptional<int32>())
+		.MinDesiredValueWidth(80.f)
 #if __cplusplus >= 202002L
-				.OnBeginSliderMovement_Lambda([=, this]()
+		.OnBeginSliderMovement_Lambda([=, this]()
 #else
-				.OnBeginSliderMovement_Lambda([=]()
+		.OnBeginSliderMovement_Lambda([=]()
 #endif
-				{
-					bSliderMoving = true;
-					GEditor->BeginTransaction(TEXT("Articy GV"), FText::FromString(TEXT("Modify Articy GV by Slider")), IntVar);
-				})
+		{
+			bSliderMoving = true;
+			GEditor->BeginTransaction(TEXT("Articy GV"), FText::FromString(TEXT("Modify Articy GV by Slider")), IntVar);
+		})
 #if __cplusplus >= 202002L
-				.OnEndSliderMovement_Lambda([=, this](int32 Value)
+		.OnEndSliderMovement_Lambda([=, this](int32 Value)
 #else
-				.OnEndSliderMovement_Lambda([=](int32 Value)
+		.OnEndSliderMovement_Lambda([=](int32 Value)
 #endif
-				{
-					bSliderMoving = false;
-					IntVar->Modify();
-					*IntVar = Value;
-					GEditor->EndTransaction();
-				})
-				.Value_Lambda([IntVar]()
-				{
-					return IntVar->Get();
-				})
-				// on value changed is only used for slider value updates
-				.OnValueChanged(this, &SArticyVariableSet::OnValueChanged, IntVar)
+		{
+			bSliderMoving = false;
+			IntVar->Modify();
+			*IntVar = Value;
+			GEditor->EndTransaction();
+		})
+		.Value_Lambda([IntVar]()
+		{
+			return IntVar->Get();
+		})
+		// on value changed is only used for slider value updates
+		.OnValueChanged(this, &SArticyGlobalVariables::OnValueChanged, IntVar)
 #if __cplusplus >= 202002L
-				.OnValueCommitted_Lambda([=, this](int32 Value, ETextCommit::Type Type)
+		.OnValueCommitted_Lambda([=, this](int32 Value, ETextCommit::Type Type)
 #else
-				.OnValueCommitted_Lambda([=](int32 Value, ETextCommit::Type Type)
+		.OnValueCommitted_Lambda([=](int32 Value, ETextCommit::Type Type)
 #endif
-				{
-					if (bSliderMoving || Value == IntVar->Get())
-					{
-						return;
-					}
-
-					const FScopedTransaction Transaction(LOCTEXT("ModifyGV", "Modified GV"));
-					IntVar->Modify();
-					*IntVar = Value;
-				})
-			];
-		}
-		else if (Var->GetClass() == UArticyBool::StaticClass())
 		{
-			UArticyBool* BoolVar = Cast<UArticyBool>(Var);
-			InnerVarSlot
-			[
-				SNew(SCheckBox)
-				.IsChecked_Lambda([BoolVar]()
-				{
-					return BoolVar->Get() ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
-				})
-				.OnCheckStateChanged_Lambda([BoolVar](const ECheckBoxState& State)
-				{
-					if(*BoolVar == (State == ECheckBoxState::Checked))
-					{
-						return;
-					}
-					
-					const FScopedTransaction Transaction(TEXT("ArticyGV"),LOCTEXT("ModifyGV", "Modified GV"), BoolVar);
-					bool bSavedInTranactionBuffer = BoolVar->Modify();
-					*BoolVar = State == ECheckBoxState::Checked;
-				})
-			];
-		}
-
-		VariableWidgetMapping.Add(Var, LocalSplitter);
+			if (bSliderMoving || Value == IntVar->Get())
+			{
+				return;
+			}
 
-		VariableContainer->AddSlot()
-		.AutoHeight()
-		.Padding(25.f, 5.f, 5.f, 5.f)
-		[
-			LocalSplitter
-		];
+			const FScopedTransaction Transaction(LOCTEXT("ModifyGV", "Modified GV"));
+			IntVar->Modify();
+			*IntVar = Value;
+		});
 	}
 
-	bVariableWidgetsBuilt = true;
-}
-
-void SArticyVariableSet::UpdateVisibility(const UArticyVariable* Variable, EVisibility InVisibility)
-{
-	if(VariableWidgetMapping.Contains(Variable))
+	if (Var->GetClass() == UArticyBool::StaticClass())
 	{
-		TWeakPtr<SWidget> VarWidget = VariableWidgetMapping[Variable];
-		VarWidget.Pin()->SetVisibility(InVisibility);
-	}
-}
-
-TArray<UArticyVariable*> SArticyVariableSet::GetVariables()
-{
-	return VariableSet->GetVariables();
-}
-
-void SArticyGlobalVariables::Construct(const FArguments& Args, TWeakObjectPtr<UArticyGlobalVariables> GV)
-{
-	VariableFilter = MakeShareable(new FFrontendFilter_ArticyVariable);
-	
-	FrontendFilters = MakeShareable(new FArticyVariableFilterCollectionType);
-	FrontendFilters->OnChanged().AddSP(this, &SArticyGlobalVariables::OnFrontendFiltersChanged);
-	GlobalVariables = GV;
-
-	SizeData.RightColumnWidth = TAttribute<float>(this, &SArticyGlobalVariables::OnGetRightColumnWidth);
-	SizeData.LeftColumnWidth = TAttribute<float>(this, &SArticyGlobalVariables::OnGetLeftColumnWidth);
-	SizeData.OnWidthChanged = SSplitter::FOnSlotResized::CreateSP(this, &SArticyGlobalVariables::OnSetColumnWidth);
-
-	bInitiallyCollapsed = Args._bInitiallyCollapsed;
-	
-	TSharedRef<SVerticalBox> ParentWidget = SNew(SVerticalBox);
-	SetContainer = SNew(SVerticalBox);
-
-	TSharedRef<SScrollBox> ScrollBox = SNew(SScrollBox).ScrollBarAlwaysVisible(true)
-	+ SScrollBox::Slot()
-	[
-		SetContainer.ToSharedRef()
-	];
+		UArticyBool* BoolVar = Cast<UArticyBool>(Var);
+		return SNew(SCheckBox)
+		.IsChecked_Lambda([BoolVar]()
+		{
+			return BoolVar->Get() ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+		})
+		.OnCheckStateChanged_Lambda([BoolVar](const ECheckBoxState& State)
+		{
+			if(*BoolVar == (State == ECheckBoxState::Checked))
+			{
+				return;
+			}
 
-	if(GlobalVariables.IsValid())
-	{
-		UpdateDisplayedGlobalVariables(GlobalVariables);
+			const FScopedTransaction Transaction(TEXT("ArticyGV"),LOCTEXT("ModifyGV", "Modified GV"), BoolVar);
+			BoolVar->Modify();
+			*BoolVar = State == ECheckBoxState::Checked;
+		});
 	}
-	
-	TSharedRef<SSearchBox> SearchBox = SNew(SSearchBox)
-		.OnTextChanged(this, &SArticyGlobalVariables::OnSearchBoxChanged)
-		.OnTextCommitted(this, &SArticyGlobalVariables::OnSearchBoxCommitted)
-		.DelayChangeNotificationsWhileTyping(true);
-
-	ParentWidget->AddSlot().AutoHeight()[SearchBox];
-	ParentWidget->AddSlot().FillHeight(1.f)[ScrollBox];
-
-	ChildSlot
-	[
-		ParentWidget
-	];
-
-	//FrontendFilters->Add(VariableFilter);
-}
-
-void SArticyGlobalVariables::UpdateDisplayedGlobalVariables(TWeakObjectPtr<UArticyGlobalVariables> InGV)
-{
-	VariableSetWidgets.Empty();
-	SetContainer->ClearChildren();
 
-	if(!InGV.IsValid())
+	if (Var->GetClass() == UArticyFloat::StaticClass())
 	{
-		return;
+		UArticyFloat* FloatVar = Cast<UArticyFloat>(Var);
+		return SNew(SNumericEntryBox<float>)
+		.AllowSpin(false)
+		.MinDesiredValueWidth(80.f)
+		.Value_Lambda([FloatVar]()
+		{
+			return FloatVar->Get();
+		})
+		.OnValueCommitted_Lambda([FloatVar](float Value, ETextCommit::Type Type)
+		{
+			if (Value == FloatVar->Get())
+			{
+				return;
+			}
+
+			const FScopedTransaction Transaction(LOCTEXT("ModifyGV", "Modified GV"));
+			FloatVar->Modify();
+			*FloatVar = Value;
+		});
 	}
-	
-	TArray<UArticyBaseVariableSet*> SortedSets = InGV->GetVariableSets();
-	SortedSets.Sort([](const UArticyBaseVariableSet& LHS, const UArticyBaseVariableSet& RHS)
-	{
-		return LHS.GetName().Compare(RHS.GetName(), ESearchCase::IgnoreCase) < 0 ? true : false;
-	});
 
-	for (UArticyBaseVariableSet* Set : SortedSets)
+	if (Var->GetClass() == UArticyEnum::StaticClass())
 	{
-		TSharedRef<SArticyVariableSet> VarSetWidget = SNew(SArticyVariableSet, Set)
-		.bInitiallyCollapsed(bInitiallyCollapsed)
-		.SizeData(&SizeData);
-
-		VariableSetWidgets.Add(VarSetWidget);
+		UArticyEnum* EnumVar = Cast<UArticyEnum>(Var);
+		return SNew(SComboButton)
+		.OnGetMenuContent_Lambda([EnumVar]()
+		{
+			FMenuBuilder MenuBuilder(true, nullptr);
+			const TArray<FName>& ValueNames = EnumVar->GetValueNames();
+			for (int32 i = 0; i < ValueNames.Num(); ++i)
+			{
+				MenuBuilder.AddMenuEntry(FText::FromName(ValueNames[i]), FText::GetEmpty(), FSlateIcon(), FUIAction(FExecuteAction::CreateLambda([EnumVar, i]()
+				{
+					if (EnumVar->Get() == i)
+					{
+						return;
+					}
 
-		SetContainer->AddSlot().AutoHeight()
+					const FScopedTransaction Transaction(LOCTEXT("ModifyGV", "Modified GV"));
+					EnumVar->Modify();
+					*EnumVar = i;
+				})));
+			}
+			return MenuBuilder.MakeWidget();
+		})
+		.ButtonContent()
 		[
-			VarSetWidget
+			SNew(STextBlock)
+			.Text_Lambda([EnumVar]()
+			{
+				return FText::FromName(EnumVar->GetValueName());
+			})
 		];
 	}
 
-	// retrigger the currently active filters
-	FrontendFilters->OnChanged().Broadcast();
+	return SNullWidget::NullWidget;
 }
 
 void SArticyGlobalVariables::OnSearchBoxChanged(const FText& InSearchText)
 {
-	SetSearchBoxText(InSearchText);
+	SetSearchText(InSearchText.ToString());
 }
 
 void SArticyGlobalVariables::OnSearchBoxCommitted(const FText& InSearchText, ETextCommit::Type CommitInfo)
 {
-	SetSearchBoxText(InSearchText);
+	SetSearchText(InSearchText.ToString());
 }
 
-void SArticyGlobalVariables::SetSearchBoxText(const FText& InSearchText)
+void SArticyGlobalVariables::SetSearchText(const FString& InSearchText)
 {
-	// Update the filter text only if it has actually changed, including case sensitivity (as operators are case sensitive)
-	if (!InSearchText.ToString().Equals(VariableFilter->GetRawFilterText().ToString(), ESearchCase::CaseSensitive))
+	const FString NewSearchText = InSearchText.ToLower();
+	if (NewSearchText.Equals(SearchText, ESearchCase::CaseSensitive))
 	{
-		VariableFilter->SetRawFilterText(InSearchText);
-
-		// add or remove the filter depending on whether the search field has content or not
-		if (InSearchText.IsEmpty() && FrontendFilters->Num() > 0)
-		{
-			FrontendFilters->Remove(VariableFilter);
-			RestoreExpansionStates();
-		}
-		else if(!InSearchText.IsEmpty() && FrontendFilters->Num() == 0)
-		{
-			CacheExpansionStates();
-			FrontendFilters->Add(VariableFilter);
-		}
+		return;
 	}
+
+	// typing more characters can only remove matches, so only the current matches have to be tested again
+	const bool bIncremental = !SearchText.IsEmpty() && NewSearchText.StartsWith(SearchText, ESearchCase::CaseSensitive);
+
+	SearchText = NewSearchText;
+	SearchText.ParseIntoArrayWS(SearchTerms);
+
+	UpdateMatchingItems(bIncremental);
 }
 
-void SArticyGlobalVariables::OnFrontendFiltersChanged()
+void SArticyGlobalVariables::UpdateMatchingItems(bool bIncremental)
 {
-	if(FrontendFilters->Num() > 0)
+	if (bIncremental)
 	{
-		bShouldForceExpand = true;
+		MatchingItems.RemoveAll([this](const int32 Index)
+		{
+			return !PassesSearch(*AllItems[Index]);
+		});
 	}
 	else
 	{
-		bShouldForceExpand = false;
-	}
-	
-	for(TSharedPtr<SArticyVariableSet> SetWidget : VariableSetWidgets)
-	{
-		uint32 NumVisible = 0;
-		TArray<UArticyVariable*> Vars = SetWidget->GetVariables();
-
-		for(UArticyVariable* Var : Vars)
+		MatchingItems.Reset();
+		for (int32 Index = 0; Index < AllItems.Num(); ++Index)
 		{
-			const UArticyVariable* VarTmp = Var;
-			if(TestAgainstFrontendFilters(Var))
+			const FArticyGVListItem& Item = *AllItems[Index];
+			if (!Item.IsNamespace() && PassesSearch(Item))
 			{
-				SetWidget->UpdateVisibility(VarTmp, EVisibility::Visible);
-				NumVisible++;
-			}
-			else
-			{
-				SetWidget->UpdateVisibility(VarTmp, EVisibility::Collapsed);
+				MatchingItems.Add(Index);
 			}
 		}
+	}
 
-		if(NumVisible > 0)
+	RefreshDisplayedItems();
+}
+
+void SArticyGlobalVariables::RefreshDisplayedItems()
+{
+	DisplayedItems.Reset();
+
+	if (SearchTerms.Num() == 0)
+	{
+		// without a search, all namespaces are shown, including empty ones
+		for (const FArticyGVListItemPtr& Item : AllItems)
 		{
-			if(bShouldForceExpand)
+			if (Item->IsNamespace() || AllItems[Item->NamespaceIndex]->bExpanded)
 			{
-				SetWidget->SetExpanded(true);
+				DisplayedItems.Add(Item);
 			}
-			
-			SetWidget->SetVisibility(EVisibility::Visible);
 		}
-		else
+	}
+	else
+	{
+		// while searching, only namespaces with matches are shown and all of them are expanded, without touching their stored expansion state
+		int32 CurrentNamespace = INDEX_NONE;
+		for (const int32 Index : MatchingItems)
 		{
-			SetWidget->SetVisibility(EVisibility::Collapsed);
+			const FArticyGVListItemPtr& Item = AllItems[Index];
+			if (Item->NamespaceIndex != CurrentNamespace)
+			{
+				CurrentNamespace = Item->NamespaceIndex;
+				DisplayedItems.Add(AllItems[CurrentNamespace]);
+			}
+
+			DisplayedItems.Add(Item);
 		}
 	}
+
+	if (ListView.IsValid())
+	{
+		ListView->RequestListRefresh();
+	}
 }
 
-bool SArticyGlobalVariables::TestAgainstFrontendFilters(const UArticyVariable* Item) const
+bool SArticyGlobalVariables::PassesSearch(const FArticyGVListItem& Item) const
 {
-	if (FrontendFilters.IsValid() && !FrontendFilters->PassesAllFilters(Item))
+	// both the search key and the terms are lowercase already
+	for (const FString& Term : SearchTerms)
 	{
-		return false;
+		if (!Item.SearchKey.Contains(Term, ESearchCase::CaseSensitive))
+		{
+			return false;
+		}
 	}
 
 	return true;
 }
 
-void SArticyGlobalVariables::CacheExpansionStates()
+void SArticyGlobalVariables::BindToGlobalVariables()
 {
-	for(TSharedPtr<SArticyVariableSet>& SetWidget : VariableSetWidgets)
+	if (GlobalVariables.IsValid())
 	{
-		ExpansionCache.Add(SetWidget, SetWidget->IsExpanded());
+		VariableChangedHandle = GlobalVariables->OnAnyVariableChanged().AddSP(this, &SArticyGlobalVariables::OnVariableChanged);
 	}
 }
 
-void SArticyGlobalVariables::RestoreExpansionStates()
+void SArticyGlobalVariables::UnbindFromGlobalVariables()
+{
+	if (GlobalVariables.IsValid() && VariableChangedHandle.IsValid())
+	{
+		GlobalVariables->OnAnyVariableChanged().Remove(VariableChangedHandle);
+	}
+
+	VariableChangedHandle.Reset();
+}
+
+void SArticyGlobalVariables::OnVariableChanged(UArticyVariable* Variable)
 {
-	// restore the previous expansion state from the forced expansion
-	for (auto It = ExpansionCache.CreateIterator(); It; ++It)
+	// values are pulled by the visible cells, so we only need to remember when the change happened
+	if (FArticyGVListItemPtr* Item = ItemsByVariable.Find(Variable))
 	{
-		It.Key()->SetExpanded(It.Value());
+		(*Item)->LastChangeTime = FPlatformTime::Seconds();
 	}
 }
 
-#undef LOCTEXT_NAMESPACE
\ No newline at end of file
+#undef LOCTEXT_NAMESPACE
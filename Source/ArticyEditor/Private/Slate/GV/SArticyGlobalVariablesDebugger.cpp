@@ -7,6 +7,7 @@
 #include "ArticyPluginSettings.h"
 #include "Widgets/Input/SNumericEntryBox.h"
 #include "Widgets/Layout/SScrollBox.h"
+#include "Widgets/Layout/SSplitter.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "Editor.h"
 
@@ -25,6 +26,7 @@ void SArticyGlobalVariablesRuntimeDebugger::Construct(const FArguments& Args)
 	});
 	
 	GlobalVariablesWidget = SNew(SArticyGlobalVariables, CurrentGlobalVariables).bInitiallyCollapsed(Args._bInitiallyCollapsed);
+	JournalViewer = SNew(SArticyChangeJournalViewer);
 
 	FMenuBuilder Builder(true, nullptr);
 
@@ -63,7 +65,18 @@ void SArticyGlobalVariablesRuntimeDebugger::Construct(const FArguments& Args)
 		// if this was autoheight the scrollbar would stop working properly
 		.FillHeight(1.f)
 		[
-			GlobalVariablesWidget.ToSharedRef()
+			SNew(SSplitter)
+			.Orientation(Orient_Vertical)
+			+ SSplitter::Slot()
+			.Value(0.65f)
+			[
+				GlobalVariablesWidget.ToSharedRef()
+			]
+			+ SSplitter::Slot()
+			.Value(0.35f)
+			[
+				JournalViewer.ToSharedRef()
+			]
 		]	
 	];
 	ChildSlot
@@ -88,6 +101,7 @@ void SArticyGlobalVariablesRuntimeDebugger::UpdateGVInstance(TWeakObjectPtr<UArt
 {
 	CurrentGlobalVariables = InGVs;
 	GlobalVariablesWidget->UpdateDisplayedGlobalVariables(CurrentGlobalVariables);
+	JournalViewer->SetGlobalVariables(CurrentGlobalVariables);
 }
 
 void SArticyGlobalVariablesRuntimeDebugger::BuildGVPickerContent(FMenuBuilder& MenuBuilder)
@@ -128,7 +142,7 @@ void SArticyGlobalVariablesRuntimeDebugger::BuildGVPickerContent(FMenuBuilder& M
 
 void SArticyGlobalVariablesRuntimeDebugger::OnSelectGVs(TWeakObjectPtr<UArticyGlobalVariables> InVars)
 {
-	CurrentGlobalVariables = InVars;
+	UpdateGVInstance(InVars);
 }
 
 bool SArticyGlobalVariablesRuntimeDebugger::IsGVChecked(TWeakObjectPtr<UArticyGlobalVariables> InVars) const
@@ -83,7 +83,9 @@ enum class EArticyType : uint8
 {
 	ADT_Boolean,
 	ADT_Integer,
-	ADT_String
+	ADT_String,
+	ADT_Float,
+	ADT_Enum
 };
 
 USTRUCT()
@@ -105,12 +107,19 @@ public:
 	int IntValue = 0;
 	UPROPERTY(VisibleAnywhere, Category = "Variable")
 	FString StringValue;
+	UPROPERTY(VisibleAnywhere, Category = "Variable")
+	float FloatValue = 0.f;
+	/** The names of all values of an enum variable, the default value is stored as index in IntValue. */
+	UPROPERTY(VisibleAnywhere, Category = "Variable")
+	TArray<FString> EnumValues;
 
 	/** Returns the UArticyVariable type to be used for this variable. */
 	FString GetCPPTypeString() const;
 	FString GetCPPValueString() const;
 
 	void ImportFromJson(const TSharedPtr<FJsonObject> JsonVar);
+	/** Changes the type of this variable if requested in the plugin settings. */
+	void ApplyTypeOverride(const FString& Namespace);
 };
 
 USTRUCT()
@@ -345,6 +354,8 @@ public:
 
 	void GatherScripts();
 	void AddScriptFragment(const FString& Fragment, const bool bIsInstruction);
+	/** Returns true if any global variable is an enum, whose string literals need to be resolved in the scripts. */
+	bool HasEnumVariables() const;
 	const TSet<FArticyExpressoFragment>& GetScriptFragments() const { return ScriptFragments; }
 
 	void AddChildToParentCache(FArticyId Parent, FArticyId Child);
@@ -392,5 +403,10 @@ private:
 
 	UPROPERTY(VisibleAnywhere, Category="Imported")
 	TMap<FArticyId, FArticyIdArray> ParentChildrenCache;
+
+	/** Value names of all enum variables by full variable name, used while gathering the scripts */
+	TMap<FString, TArray<FString>> EnumVariableValues;
+	/** Full names of all string variables, used while gathering the scripts */
+	TSet<FString> StringVariables;
 };
 
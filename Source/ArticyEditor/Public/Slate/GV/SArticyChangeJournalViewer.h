@@ -0,0 +1,50 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Widgets/Views/SListView.h"
+#include "ArticyGlobalVariables.h"
+
+typedef TSharedPtr<FArticyJournalEntry> FArticyJournalEntryPtr;
+
+/**
+ * Displays the change journal of a global variables instance, newest change first.
+ * Every entry can be used to rewind the global variables to the state right after that change.
+ */
+class SArticyChangeJournalViewer : public SCompoundWidget
+{
+	SLATE_BEGIN_ARGS(SArticyChangeJournalViewer) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& Args);
+	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+
+	void SetGlobalVariables(TWeakObjectPtr<UArticyGlobalVariables> InGV);
+
+private:
+	TSharedRef<ITableRow> OnGenerateRow(FArticyJournalEntryPtr Entry, const TSharedRef<STableViewBase>& OwnerTable);
+	/** Copies the entries recorded since the last refresh, and drops the ones which are not in the journal anymore */
+	void RefreshEntries(bool bForce = false);
+	TSharedPtr<FArticyChangeJournal> GetJournal() const;
+
+	FText GetStatusText() const;
+	ECheckBoxState IsJournalEnabled() const;
+	void OnJournalEnabledChanged(ECheckBoxState NewState);
+	FReply OnClearClicked();
+	FReply OnRewindClicked(uint32 Sequence);
+
+private:
+	TWeakObjectPtr<UArticyGlobalVariables> GlobalVariables;
+	TSharedPtr<SListView<FArticyJournalEntryPtr>> ListView;
+	TArray<FArticyJournalEntryPtr> Entries;
+
+	/** The journal state the displayed entries were copied from */
+	TWeakPtr<FArticyChangeJournal> DisplayedJournal;
+	uint32 DisplayedSequence = 0;
+	uint32 DisplayedGeneration = 0;
+};
@@ -7,11 +7,10 @@
 #include "CoreMinimal.h"
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "ArticyGlobalVariables.h"
-#include "Misc/TextFilterExpressionEvaluator.h"
-#include "Slate/ArticyFilterHelpers.h"
 #include "Widgets/SCompoundWidget.h"
-#include "Widgets/Layout/SExpandableArea.h"
 #include "Widgets/Layout/SSplitter.h"
+#include "Widgets/Views/SListView.h"
+#include "Widgets/Views/STableRow.h"
 #include "Widgets/SBoxPanel.h"
 
 /** ref: detailcategorygroupnode.cpp */
@@ -24,54 +23,30 @@ struct FGlobalVariablesSizeData
 	void SetColumnWidth(float InWidth) { OnWidthChanged.ExecuteIfBound(InWidth); }
 };
 
-class SArticyVariableSet : public SCompoundWidget
+/**
+ * A single row of the global variables list, either a namespace header or a variable.
+ * All rows are created once per GV instance; filtering and expansion only change which of them are displayed.
+ */
+struct FArticyGVListItem
 {
-	SLATE_BEGIN_ARGS(SArticyVariableSet) :
-	_bInitiallyCollapsed(true),
-	_SizeData(nullptr)
-	{}
-
-	SLATE_ARGUMENT(bool, bInitiallyCollapsed)
-	SLATE_ARGUMENT(const FGlobalVariablesSizeData*, SizeData)
-	
-	SLATE_END_ARGS()
-
-	void Construct(const FArguments& Args, TWeakObjectPtr<UArticyBaseVariableSet> VariableSet);
-	void SetExpanded(bool bInExpanded) const;
-	bool IsExpanded() const;
-	void UpdateVisibility(const UArticyVariable* Variable, EVisibility InVisibility);
-	TArray<UArticyVariable*> GetVariables();
-
-private:
-	void BuildVariableWidgets();
-
-private:
-	bool bVariableWidgetsBuilt = false;
-	bool bSliderMoving = false;
-	TWeakObjectPtr<UArticyBaseVariableSet> VariableSet;
-	TMap<UArticyVariable*, TWeakPtr<SWidget>> VariableWidgetMapping;
-	TSharedPtr<SVerticalBox> VariableContainer;
-	TSharedPtr<SExpandableArea> NamespaceExpansion;
-
-	const FGlobalVariablesSizeData* SizeData = nullptr;
-
-	template<typename T, typename T2>
-	void OnValueChanged(T Value, T2* Var);
+	TWeakObjectPtr<UArticyBaseVariableSet> Set;
+	/** The variable of this row, null for namespace headers. */
+	TWeakObjectPtr<UArticyVariable> Variable;
+	/** The name displayed in the row. */
+	FString DisplayName;
+	/** Lowercase "namespace.variable" (or just "namespace" for headers), precomputed for filtering. */
+	FString SearchKey;
+	/** Index of the owning namespace header in the list of all items. */
+	int32 NamespaceIndex = INDEX_NONE;
+	/** Whether this namespace is expanded (only used by namespace headers). */
+	bool bExpanded = true;
+	/** The time the variable last changed at runtime, used to highlight fresh changes. */
+	double LastChangeTime = -1.0;
+
+	bool IsNamespace() const { return NamespaceIndex == INDEX_NONE; }
 };
 
-template <typename T, typename T2>
-void SArticyVariableSet::OnValueChanged(T Value, T2* Var)
-{
-	if(bSliderMoving)
-	{		
-		if(Var->Get() == Value)
-		{
-			return;
-		}
-		Var->Modify();
-		*Var = Value;
-	}
-}
+typedef TSharedPtr<FArticyGVListItem> FArticyGVListItemPtr;
 
 class SArticyGlobalVariables : public SCompoundWidget
 {
@@ -81,6 +56,8 @@ class SArticyGlobalVariables : public SCompoundWidget
 		SLATE_ARGUMENT(bool, bInitiallyCollapsed)
     SLATE_END_ARGS()
 
+	virtual ~SArticyGlobalVariables();
+
     void Construct(const FArguments& Args, TWeakObjectPtr<UArticyGlobalVariables> GV);
 
 	void UpdateDisplayedGlobalVariables(TWeakObjectPtr<UArticyGlobalVariables> InGV);
@@ -92,31 +69,61 @@ private:
 	// ref: SDetailsView
 	float ColumnWidth = 0.65f;
     bool bInitiallyCollapsed = true;
+	bool bSliderMoving = false;
 private:
 	float OnGetLeftColumnWidth() const { return 1.0f - ColumnWidth; }
 	float OnGetRightColumnWidth() const { return ColumnWidth; }
 	void OnSetColumnWidth(float InWidth) { ColumnWidth = InWidth; }
 
 private:
+	TSharedRef<ITableRow> OnGenerateRow(FArticyGVListItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<SWidget> MakeNamespaceWidget(FArticyGVListItemPtr Item);
+	TSharedRef<SWidget> MakeVariableWidget(FArticyGVListItemPtr Item);
+	TSharedRef<SWidget> MakeValueWidget(UArticyVariable* Var);
+
 	void OnSearchBoxChanged(const FText& InSearchText);
 	void OnSearchBoxCommitted(const FText& InSearchText, ETextCommit::Type CommitInfo);
-	void SetSearchBoxText(const FText& InSearchText);
-	void OnFrontendFiltersChanged();
-	bool TestAgainstFrontendFilters(const UArticyVariable* Item) const;
+	void SetSearchText(const FString& InSearchText);
+
+	/** Runs the name filter, reusing the previous result if the new search only narrows it down. */
+	void UpdateMatchingItems(bool bIncremental);
+	/** Rebuilds the list source from the matching items and the expansion state. */
+	void RefreshDisplayedItems();
+	bool PassesSearch(const FArticyGVListItem& Item) const;
+
+	void BindToGlobalVariables();
+	void UnbindFromGlobalVariables();
+	void OnVariableChanged(UArticyVariable* Variable);
+
+	template<typename T, typename T2>
+	void OnValueChanged(T Value, T2* Var);
 
-	void CacheExpansionStates();
-	void RestoreExpansionStates();
-	
 private:
-	TSharedPtr<SVerticalBox> SetContainer;
-	//TSet<TWeakObjectPtr<UArticyVariable>> VisibleVariables;
-	TArray<TSharedPtr<SArticyVariableSet>> VariableSetWidgets;
-	/** Used to force expand all sets when a search has some results */
-	bool bShouldForceExpand = false;
-	/** Caches the current expansion state to restore it when the search terms are removed */
-	TMap<TSharedPtr<SArticyVariableSet>, bool> ExpansionCache;
-	/** The filter that checks against variable names */
-	TSharedPtr<FFrontendFilter_ArticyVariable> VariableFilter;
-	/** The collection of filters */
-	TSharedPtr<FArticyVariableFilterCollectionType> FrontendFilters;
+	TSharedPtr<SListView<FArticyGVListItemPtr>> ListView;
+	/** All namespace and variable rows, sorted by namespace and variable name. */
+	TArray<FArticyGVListItemPtr> AllItems;
+	/** Indices into AllItems of all variables passing the current search. */
+	TArray<int32> MatchingItems;
+	/** The rows which are currently part of the list (namespace headers and visible variables). */
+	TArray<FArticyGVListItemPtr> DisplayedItems;
+	/** Maps each variable to its row, used when a change is reported. */
+	TMap<TWeakObjectPtr<UArticyVariable>, FArticyGVListItemPtr> ItemsByVariable;
+	/** The lowercase search text, and the whitespace separated terms which all have to match. */
+	FString SearchText;
+	TArray<FString> SearchTerms;
+	FDelegateHandle VariableChangedHandle;
 };
+
+template <typename T, typename T2>
+void SArticyGlobalVariables::OnValueChanged(T Value, T2* Var)
+{
+	if(bSliderMoving)
+	{
+		if(Var->Get() == Value)
+		{
+			return;
+		}
+		Var->Modify();
+		*Var = Value;
+	}
+}
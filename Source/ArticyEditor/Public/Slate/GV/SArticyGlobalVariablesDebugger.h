@@ -9,6 +9,7 @@
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "ArticyGlobalVariables.h"
 #include "Slate/GV/SArticyGlobalVariables.h"
+#include "Slate/GV/SArticyChangeJournalViewer.h"
 #include "Misc/TextFilterExpressionEvaluator.h"
 #include "Widgets/Layout/SExpandableArea.h"
 #include "Widgets/Layout/SWidgetSwitcher.h"
@@ -34,6 +35,7 @@ private:
 private:
 	TWeakObjectPtr<UArticyGlobalVariables> CurrentGlobalVariables;
 	TSharedPtr<SArticyGlobalVariables> GlobalVariablesWidget;
+	TSharedPtr<SArticyChangeJournalViewer> JournalViewer;
 	TSharedPtr<SWidget> WorldSelector;
 	TSharedPtr<SWidgetSwitcher> RuntimeSwitcher;
 
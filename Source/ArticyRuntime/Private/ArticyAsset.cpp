@@ -3,42 +3,156 @@
 //
 
 #include "ArticyAsset.h"
-#include "UObject/ConstructorHelpers.h"
+#include "Engine/AssetManager.h"
 #include "Misc/Paths.h"
+#include "ArticyDatabase.h"
+#include "Interfaces/ArticyObjectWithSpeaker.h"
 
-UObject* UArticyAsset::LoadAsset() const
+namespace
 {
-	//if(!Asset.IsValid())
-	{
-		/*static TArray<FAssetData> assets;
+	using FResolveArticyObject = TFunctionRef<UArticyObject*(const FArticyId&)>;
 
-		if(assets.Num() == 0)
+	void AddReferencedAsset(FResolveArticyObject Resolve, const FArticyId& Id, TArray<UArticyAsset*>& OutAssets)
+	{
+		if (!Id.IsNull())
 		{
-			static TWeakObjectPtr<UObjectLibrary> lib = nullptr;
-			if(!lib.IsValid())
-				lib = UObjectLibrary::CreateLibrary(UObject::StaticClass(), false, GIsEditor);
+			if (auto asset = Cast<UArticyAsset>(Resolve(Id)))
+				OutAssets.AddUnique(asset);
+		}
+	}
 
-			lib->LoadAssetDataFromPath(ArticyHelpers::ArticyAssetsFolder);
-			lib->GetAssetDataList(assets);
-		}*/
+	void CollectReferencedAssets(FResolveArticyObject Resolve, const UObject* Object, TArray<UArticyAsset*>& OutAssets)
+	{
+		for (TFieldIterator<FProperty> it(Object->GetClass()); it; ++it)
+		{
+			const FProperty* property = *it;
+			if (auto structProperty = CastField<FStructProperty>(property))
+			{
+				if (structProperty->Struct == FArticyId::StaticStruct())
+					AddReferencedAsset(Resolve, *structProperty->ContainerPtrToValuePtr<FArticyId>(Object), OutAssets);
+			}
+			else if (auto arrayProperty = CastField<FArrayProperty>(property))
+			{
+				auto innerProperty = CastField<FStructProperty>(arrayProperty->Inner);
+				if (innerProperty && innerProperty->Struct == FArticyId::StaticStruct())
+				{
+					for (const auto& id : *arrayProperty->ContainerPtrToValuePtr<TArray<FArticyId>>(Object))
+						AddReferencedAsset(Resolve, id, OutAssets);
+				}
+			}
+			else if (auto objectProperty = CastField<FObjectPropertyBase>(property))
+			{
+				// features and the preview image are subobjects, other referenced objects are not followed
+				auto value = objectProperty->GetObjectPropertyValue_InContainer(Object);
+				if (value && value->GetOuter() == Object)
+					CollectReferencedAssets(Resolve, value, OutAssets);
+			}
+		}
+	}
+}
 
-		const auto folder = FPaths::GetPath(AssetRef);
-		const auto filename = FPaths::GetBaseFilename(AssetRef); //without extension
+UObject* UArticyAsset::LoadAsset() const
+{
+	if (!Asset.IsValid())
+	{
+		// assets imported before the path was stored
+		if (AssetPath.IsNull())
+			const_cast<UArticyAsset*>(this)->UpdateAssetPath();
 
-		//construct the asset path like UE4 wants it
-		auto path = ArticyHelpers::GetArticyResourcesFolder() / folder / filename;
-		//UE_LOG(LogTemp, Warning, TEXT("Asset Path %s"), *path)
-#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 24
-		Asset = ConstructorHelpersInternal::FindOrLoadObject<UObject>(path);
-#else
-		Asset = ConstructorHelpersInternal::FindOrLoadObject<UObject>(path, LOAD_None);
-#endif
-		
+		Asset = AssetPath.TryLoad();
 	}
 
 	return Asset.Get();
 }
 
+UObject* UArticyAsset::GetLoadedAsset() const
+{
+	if (!Asset.IsValid())
+		Asset = AssetPath.ResolveObject();
+
+	return Asset.Get();
+}
+
+void UArticyAsset::LoadAssetAsync(TFunction<void(UObject*)> OnLoaded) const
+{
+	if (auto loaded = GetLoadedAsset())
+	{
+		OnLoaded(loaded);
+		return;
+	}
+
+	if (AssetPath.IsNull() || !UAssetManager::IsValid())
+	{
+		OnLoaded(LoadAsset());
+		return;
+	}
+
+	// the streamable manager merges requests for the same asset, so this is safe to call repeatedly
+	TWeakObjectPtr<const UArticyAsset> weakThis = this;
+	auto handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPath, [weakThis, OnLoaded]()
+	{
+		OnLoaded(weakThis.IsValid() ? weakThis->GetLoadedAsset() : nullptr);
+	});
+
+	// a handle which is still loading is only released once it completed, so its callback is still called
+	if (LoadHandle.IsValid())
+		LoadHandle->ReleaseHandle();
+	LoadHandle = handle;
+}
+
+void UArticyAsset::ReleaseAsset()
+{
+	if (LoadHandle.IsValid())
+	{
+		LoadHandle->ReleaseHandle();
+		LoadHandle.Reset();
+	}
+}
+
+void UArticyAsset::UpdateAssetPath()
+{
+	const auto folder = FPaths::GetPath(AssetRef);
+	const auto filename = FPaths::GetBaseFilename(AssetRef); //without extension
+
+	//construct the asset path like UE4 wants it, including the object name
+	AssetPath = AssetRef.IsEmpty() ? FSoftObjectPath() : FSoftObjectPath(ArticyHelpers::GetArticyResourcesFolder() / folder / filename + TEXT(".") + filename);
+}
+
+void UArticyAsset::PostLoad()
+{
+	Super::PostLoad();
+
+	if (AssetPath.IsNull())
+		UpdateAssetPath();
+}
+
+void UArticyAsset::BeginDestroy()
+{
+	ReleaseAsset();
+
+	Super::BeginDestroy();
+}
+
+void UArticyAsset::GetReferencedAssets(const UArticyDatabase* Database, const UObject* Object, TArray<UArticyAsset*>& OutAssets)
+{
+	if (Database)
+		GetReferencedAssets(Object, OutAssets, [Database](const FArticyId& Id) { return Database->GetObject(Id); });
+}
+
+void UArticyAsset::GetReferencedAssets(const UObject* Object, TArray<UArticyAsset*>& OutAssets, TFunctionRef<UArticyObject*(const FArticyId&)> Resolve)
+{
+	if (!Object)
+		return;
+
+	CollectReferencedAssets(Resolve, Object, OutAssets);
+
+	if (auto speakerProvider = Cast<IArticyObjectWithSpeaker>(Object))
+	{
+		if (auto speaker = Resolve(speakerProvider->GetSpeakerId()))
+			CollectReferencedAssets(Resolve, speaker, OutAssets);
+	}
+}
+
 UTexture* UArticyAsset::LoadAsTexture() const
 {
 	return Cast<UTexture>(LoadAsset());
@@ -59,4 +173,33 @@ UFileMediaSource* UArticyAsset::LoadAsFileMediaSource() const
 	return Cast<UFileMediaSource>(LoadAsset());
 }
 
+//---------------------------------------------------------------------------//
+
+UArticyLoadAssetAsyncAction* UArticyLoadAssetAsyncAction::LoadArticyAssetAsync(const UObject* WorldContext, UArticyAsset* ArticyAsset)
+{
+	auto action = NewObject<UArticyLoadAssetAsyncAction>();
+	action->ArticyAsset = ArticyAsset;
+	action->RegisterWithGameInstance(WorldContext);
+
+	return action;
+}
+
+void UArticyLoadAssetAsyncAction::Activate()
+{
+	if (!ArticyAsset)
+	{
+		OnLoaded.Broadcast(nullptr);
+		SetReadyToDestroy();
+		return;
+	}
 
+	TWeakObjectPtr<UArticyLoadAssetAsyncAction> weakThis = this;
+	ArticyAsset->LoadAssetAsync([weakThis](UObject* Loaded)
+	{
+		if (weakThis.IsValid())
+		{
+			weakThis->OnLoaded.Broadcast(Loaded);
+			weakThis->SetReadyToDestroy();
+		}
+	});
+}
@@ -0,0 +1,331 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "ArticyChangeJournal.h"
+#include "ArticyGlobalVariables.h"
+#include "ArticyExpressoScripts.h"
+#include "ArticyRuntimeModule.h"
+
+FArticyChangeJournal* FArticyChangeJournal::Active = nullptr;
+
+FArticyChangeJournal::FArticyChangeJournal(const int32 InCapacity)
+{
+	Entries.SetNum(FMath::Max(1, InCapacity));
+}
+
+void FArticyChangeJournal::RecordVariable(UArticyVariable* Variable, const bool& OldValue, const bool& NewValue)
+{
+	if (auto entry = AddEntry(Variable, NAME_None))
+	{
+		entry->OldValue.Type = entry->NewValue.Type = EArticyJournalValueType::Bool;
+		entry->OldValue.BoolValue = OldValue;
+		entry->NewValue.BoolValue = NewValue;
+	}
+}
+
+void FArticyChangeJournal::RecordVariable(UArticyVariable* Variable, const int32& OldValue, const int32& NewValue)
+{
+	if (auto entry = AddEntry(Variable, NAME_None))
+	{
+		entry->OldValue.Type = entry->NewValue.Type = EArticyJournalValueType::Int;
+		entry->OldValue.IntValue = OldValue;
+		entry->NewValue.IntValue = NewValue;
+	}
+}
+
+void FArticyChangeJournal::RecordVariable(UArticyVariable* Variable, const FString& OldValue, const FString& NewValue)
+{
+	if (auto entry = AddEntry(Variable, NAME_None))
+	{
+		entry->OldValue.Type = entry->NewValue.Type = EArticyJournalValueType::String;
+		entry->OldValue.StringIndex = InternString(OldValue);
+		entry->NewValue.StringIndex = InternString(NewValue);
+	}
+}
+
+void FArticyChangeJournal::RecordVariable(UArticyVariable* Variable, const float& OldValue, const float& NewValue)
+{
+	if (auto entry = AddEntry(Variable, NAME_None))
+	{
+		entry->OldValue.Type = entry->NewValue.Type = EArticyJournalValueType::Float;
+		entry->OldValue.FloatValue = OldValue;
+		entry->NewValue.FloatValue = NewValue;
+	}
+}
+
+void FArticyChangeJournal::RecordProperty(UArticyBaseObject* Object, const FName& Property, const ExpressoType& OldValue, const ExpressoType& NewValue)
+{
+	if (auto entry = AddEntry(Object, Property))
+	{
+		entry->OldValue = MakeValue(OldValue);
+		entry->NewValue = MakeValue(NewValue);
+	}
+}
+
+const FArticyJournalEntry& FArticyChangeJournal::GetEntry(const int32 Index) const
+{
+	check(Index >= 0 && Index < Count);
+	return Entries[(Head + Index) % Entries.Num()];
+}
+
+void FArticyChangeJournal::GetEntries(TArray<FArticyJournalEntry>& OutEntries, const uint32 SinceSequence) const
+{
+	FindEntries([SinceSequence](const FArticyJournalEntry& Entry) { return Entry.Sequence > SinceSequence; }, OutEntries);
+}
+
+void FArticyChangeJournal::FindEntries(TFunctionRef<bool(const FArticyJournalEntry&)> Predicate, TArray<FArticyJournalEntry>& OutEntries) const
+{
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const auto& entry = GetEntry(i);
+		if (Predicate(entry))
+			OutEntries.Add(entry);
+	}
+}
+
+const FString& FArticyChangeJournal::GetString(const int32 Index) const
+{
+	static const FString Invalid;
+	return Strings.IsValidIndex(Index) ? Strings[Index] : Invalid;
+}
+
+FString FArticyChangeJournal::ValueToString(const FArticyJournalValue& Value) const
+{
+	switch (Value.Type)
+	{
+	case EArticyJournalValueType::Bool:
+		return Value.BoolValue ? TEXT("true") : TEXT("false");
+	case EArticyJournalValueType::Int:
+		return FString::Printf(TEXT("%lld"), Value.IntValue);
+	case EArticyJournalValueType::Float:
+		return FString::SanitizeFloat(Value.FloatValue);
+	case EArticyJournalValueType::String:
+		return GetString(Value.StringIndex);
+	default:
+		return TEXT("<none>");
+	}
+}
+
+int32 FArticyChangeJournal::RewindTo(const uint32 Sequence)
+{
+	TGuardValue<bool> rewindGuard(bIsRewinding, true);
+
+	int32 numUndone = 0;
+	while (Count > 0)
+	{
+		auto& entry = Entries[(Head + Count - 1) % Entries.Num()];
+		if (entry.Sequence <= Sequence)
+			break;
+
+		Undo(entry);
+		ReleaseValue(entry.OldValue);
+		ReleaseValue(entry.NewValue);
+		--Count;
+		++numUndone;
+	}
+
+	if (numUndone > 0)
+		++Generation;
+
+	// continue the sequence right after the rewind target, so the numbers stay consecutive
+	NextSequence = Count > 0 ? GetEntry(Count - 1).Sequence + 1 : FMath::Min(NextSequence, Sequence + 1);
+
+	return numUndone;
+}
+
+void FArticyChangeJournal::Reset()
+{
+	for (auto& entry : Entries)
+	{
+		entry.OldValue = FArticyJournalValue();
+		entry.NewValue = FArticyJournalValue();
+	}
+
+	Head = 0;
+	Count = 0;
+	Strings.Reset();
+	StringIndices.Reset();
+	StringRefCounts.Reset();
+	FreeStrings.Reset();
+	++Generation;
+}
+
+FArticyJournalEntry* FArticyChangeJournal::AddEntry(UObject* Target, const FName& Property)
+{
+	if (bIsRewinding)
+		return nullptr;
+
+	int32 index;
+	if (Count < Entries.Num())
+	{
+		index = (Head + Count) % Entries.Num();
+		++Count;
+	}
+	else
+	{
+		// the journal is full, overwrite the oldest entry
+		index = Head;
+		Head = (Head + 1) % Entries.Num();
+	}
+
+	auto& entry = Entries[index];
+	// the strings of an overwritten entry are not needed anymore
+	ReleaseValue(entry.OldValue);
+	ReleaseValue(entry.NewValue);
+
+	entry.Sequence = NextSequence++;
+	entry.FragmentHash = CurrentFragmentHash;
+	entry.Frame = GFrameCounter;
+	entry.Target = Target;
+	entry.Property = Property;
+	entry.Self = CurrentSelf;
+	entry.Speaker = CurrentSpeaker;
+
+	return &entry;
+}
+
+FArticyJournalValue FArticyChangeJournal::MakeValue(const ExpressoType& Value)
+{
+	FArticyJournalValue value;
+	switch (Value.Type)
+	{
+	case ExpressoType::Bool:
+		value.Type = EArticyJournalValueType::Bool;
+		value.BoolValue = Value.GetBool();
+		break;
+	case ExpressoType::Int:
+		value.Type = EArticyJournalValueType::Int;
+		value.IntValue = Value.GetInt();
+		break;
+	case ExpressoType::Float:
+		value.Type = EArticyJournalValueType::Float;
+		value.FloatValue = Value.GetFloat();
+		break;
+	case ExpressoType::String:
+		value.Type = EArticyJournalValueType::String;
+		value.StringIndex = InternString(Value.GetString());
+		break;
+	case ExpressoType::ObjectRef:
+		// properties referencing objects are id slots, which have no clone id
+		value.Type = EArticyJournalValueType::Int;
+		value.IntValue = static_cast<int64>(Value.ObjectId);
+		break;
+	default:
+		break;
+	}
+
+	return value;
+}
+
+int32 FArticyChangeJournal::InternString(const FString& String)
+{
+	if (const int32* index = StringIndices.Find(String))
+	{
+		++StringRefCounts[*index];
+		return *index;
+	}
+
+	int32 index;
+	if (FreeStrings.Num() > 0)
+	{
+		index = FreeStrings.Pop();
+		Strings[index] = String;
+		StringRefCounts[index] = 1;
+	}
+	else
+	{
+		index = Strings.Add(String);
+		StringRefCounts.Add(1);
+	}
+
+	StringIndices.Add(String, index);
+	return index;
+}
+
+void FArticyChangeJournal::ReleaseValue(FArticyJournalValue& Value)
+{
+	if (Value.Type == EArticyJournalValueType::String && StringRefCounts.IsValidIndex(Value.StringIndex) && --StringRefCounts[Value.StringIndex] == 0)
+	{
+		StringIndices.Remove(Strings[Value.StringIndex]);
+		Strings[Value.StringIndex].Empty();
+		FreeStrings.Add(Value.StringIndex);
+	}
+
+	Value = FArticyJournalValue();
+}
+
+void FArticyChangeJournal::Undo(const FArticyJournalEntry& Entry)
+{
+	UObject* target = Entry.Target.Get();
+	if (!target)
+	{
+		UE_LOG(LogArticyRuntime, Warning, TEXT("Cannot rewind change #%u, the changed object does not exist anymore."), Entry.Sequence);
+		return;
+	}
+
+	const auto& oldValue = Entry.OldValue;
+
+	if (Entry.IsVariableChange())
+	{
+		if (auto boolVar = Cast<UArticyBool>(target))
+			boolVar->Set(oldValue.BoolValue);
+		else if (auto intVar = Cast<UArticyInt>(target))
+			intVar->Set(static_cast<int32>(oldValue.IntValue));
+		else if (auto stringVar = Cast<UArticyString>(target))
+			stringVar->Set(GetString(oldValue.StringIndex));
+		else if (auto floatVar = Cast<UArticyFloat>(target))
+			floatVar->Set(static_cast<float>(oldValue.FloatValue));
+		else if (auto enumVar = Cast<UArticyEnum>(target))
+			enumVar->Set(static_cast<int32>(oldValue.IntValue));
+
+		return;
+	}
+
+	auto object = Cast<UArticyBaseObject>(target);
+	if (!object)
+		return;
+
+	ExpressoType value;
+	switch (oldValue.Type)
+	{
+	case EArticyJournalValueType::Bool: value = ExpressoType(oldValue.BoolValue); break;
+	case EArticyJournalValueType::Int: value = ExpressoType(oldValue.IntValue); break;
+	case EArticyJournalValueType::Float: value = ExpressoType(oldValue.FloatValue); break;
+	case EArticyJournalValueType::String: value = ExpressoType(GetString(oldValue.StringIndex)); break;
+	default: return;
+	}
+
+	value.SetValue(object, Entry.Property.ToString());
+}
+
+//---------------------------------------------------------------------------//
+
+FArticyJournalScope::FArticyJournalScope(FArticyChangeJournal* InJournal, const int32 FragmentHash, UObject* Self, UObject* Speaker)
+	: Journal(InJournal), PreviousActive(FArticyChangeJournal::Active)
+{
+	FArticyChangeJournal::Active = Journal;
+
+	if (Journal)
+	{
+		PreviousFragmentHash = Journal->CurrentFragmentHash;
+		PreviousSelf = Journal->CurrentSelf;
+		PreviousSpeaker = Journal->CurrentSpeaker;
+
+		Journal->CurrentFragmentHash = FragmentHash;
+		Journal->CurrentSelf = Self;
+		Journal->CurrentSpeaker = Speaker;
+	}
+}
+
+FArticyJournalScope::~FArticyJournalScope()
+{
+	if (Journal)
+	{
+		Journal->CurrentFragmentHash = PreviousFragmentHash;
+		Journal->CurrentSelf = PreviousSelf;
+		Journal->CurrentSpeaker = PreviousSpeaker;
+	}
+
+	FArticyChangeJournal::Active = PreviousActive;
+}
@@ -8,7 +8,12 @@
 #include "ArticyGlobalVariables.h"
 #include "ArticyPluginSettings.h"
 #include "ArticyExpressoScripts.h"
+#include "ArticyChangeJournal.h"
+#include "ArticySubsystem.h"
+#include "Interfaces/ArticyObjectWithText.h"
+#include "Interfaces/ArticyConditionProvider.h"
 #include "Misc/Paths.h"
+#include "Engine/AssetManager.h"
 
 UArticyObject* FArticyObjectShadow::GetObject()
 {
@@ -60,66 +65,341 @@ UArticyObject* FArticyShadowableObject::Get(const IShadowStateManager* ShadowMan
 	return obj;
 }
 
+namespace
+{
+	void ResetFromSource(UObject* Target, const UObject* Source);
+
+	/** Replaces the subobjects of Source referenced by Value, which was copied from Source, with duplicates owned by Target. */
+	void DuplicateOwnedObjects(const FProperty* Property, void* Value, const UObject* Source, UObject* Target)
+	{
+		if (auto objectProperty = CastField<FObjectPropertyBase>(Property))
+		{
+			UObject* object = objectProperty->GetObjectPropertyValue(Value);
+			if (object && object->GetOuter() == Source)
+				objectProperty->SetObjectPropertyValue(Value, DuplicateObject(object, Target));
+		}
+		else if (auto structProperty = CastField<FStructProperty>(Property))
+		{
+			for (TFieldIterator<FProperty> it(structProperty->Struct); it; ++it)
+			{
+				for (int32 i = 0; i < it->ArrayDim; ++i)
+					DuplicateOwnedObjects(*it, it->ContainerPtrToValuePtr<void>(Value, i), Source, Target);
+			}
+		}
+		else if (auto arrayProperty = CastField<FArrayProperty>(Property))
+		{
+			FScriptArrayHelper helper(arrayProperty, Value);
+			for (int32 i = 0; i < helper.Num(); ++i)
+				DuplicateOwnedObjects(arrayProperty->Inner, helper.GetRawPtr(i), Source, Target);
+		}
+		else if (auto mapProperty = CastField<FMapProperty>(Property))
+		{
+			FScriptMapHelper helper(mapProperty, Value);
+			for (int32 i = 0; i < helper.GetMaxIndex(); ++i)
+			{
+				if (!helper.IsValidIndex(i))
+					continue;
+				DuplicateOwnedObjects(mapProperty->KeyProp, helper.GetKeyPtr(i), Source, Target);
+				DuplicateOwnedObjects(mapProperty->ValueProp, helper.GetValuePtr(i), Source, Target);
+			}
+			//the keys might have changed
+			helper.Rehash();
+		}
+		else if (auto setProperty = CastField<FSetProperty>(Property))
+		{
+			FScriptSetHelper helper(setProperty, Value);
+			for (int32 i = 0; i < helper.GetMaxIndex(); ++i)
+			{
+				if (helper.IsValidIndex(i))
+					DuplicateOwnedObjects(setProperty->ElementProp, helper.GetElementPtr(i), Source, Target);
+			}
+			helper.Rehash();
+		}
+	}
+
+	/** Resets a single value of Target to the one of Source, reusing the subobjects Target already owns where possible. */
+	void ResetValue(const FProperty* Property, void* TargetValue, const void* SourceValue, UObject* Target, const UObject* Source)
+	{
+		if (auto objectProperty = CastField<FObjectPropertyBase>(Property))
+		{
+			UObject* sourceObject = objectProperty->GetObjectPropertyValue(SourceValue);
+			if (sourceObject && sourceObject->GetOuter() == Source)
+			{
+				UObject* targetObject = objectProperty->GetObjectPropertyValue(TargetValue);
+				if (targetObject && targetObject->GetOuter() == Target && targetObject->GetClass() == sourceObject->GetClass())
+					ResetFromSource(targetObject, sourceObject);
+				else
+					objectProperty->SetObjectPropertyValue(TargetValue, DuplicateObject(sourceObject, Target));
+				return;
+			}
+		}
+		else if (auto arrayProperty = CastField<FArrayProperty>(Property))
+		{
+			//arrays (like the pins and their connections) are reset element by element, so their subobjects are reused too
+			FScriptArrayHelper source(arrayProperty, SourceValue);
+			FScriptArrayHelper target(arrayProperty, TargetValue);
+			target.Resize(source.Num());
+			for (int32 i = 0; i < source.Num(); ++i)
+				ResetValue(arrayProperty->Inner, target.GetRawPtr(i), source.GetRawPtr(i), Target, Source);
+			return;
+		}
+
+		//anything else is copied, and the subobjects of Source it references are duplicated
+		Property->CopySingleValue(TargetValue, SourceValue);
+		DuplicateOwnedObjects(Property, TargetValue, Source, Target);
+	}
+
+	/**
+	 * Resets all properties of Target to the values of Source, so Target ends up like a fresh duplicate of Source.
+	 * Subobjects owned by Source (like features and pins), also inside of containers and structs,
+	 * are not shared, but reset recursively or duplicated.
+	 */
+	void ResetFromSource(UObject* Target, const UObject* Source)
+	{
+		for (TFieldIterator<FProperty> it(Source->GetClass()); it; ++it)
+		{
+			FProperty* property = *it;
+			if (property->HasAnyPropertyFlags(CPF_Transient))
+				continue;
+
+			for (int32 i = 0; i < property->ArrayDim; ++i)
+				ResetValue(property, property->ContainerPtrToValuePtr<void>(Target, i), property->ContainerPtrToValuePtr<void>(Source, i), Target, Source);
+		}
+	}
+}
+
+/** The property values a delta clone overrides, by property path ("Property" or "Feature.Property"). */
+struct FArticyCloneDelta
+{
+	TMap<FName, ExpressoType> Overrides;
+};
+
 UArticyObject* UArticyCloneableObject::Get(const IShadowStateManager* ShadowManager, int32 CloneId,
                                            bool bForceUnshadowed) const
 {
 	auto info = Clones.Find(CloneId);
+	if(!info && DeltaClones.Contains(CloneId))
+	{
+		//a real object is needed now; the delta clone turns into a full clone
+		const_cast<UArticyCloneableObject*>(this)->MaterializeDeltaClone(ShadowManager, CloneId);
+		info = Clones.Find(CloneId);
+	}
+
 	return info ? info->Get(ShadowManager, bForceUnshadowed) : nullptr;
 }
 
 UArticyObject* UArticyCloneableObject::Clone(const IShadowStateManager* ShadowManager, int32 CloneId,
                                              bool bFailIfExists)
 {
-	auto clone = Get(ShadowManager, CloneId);
-
-	if(bFailIfExists && clone)
+	if(bFailIfExists && HasClone(CloneId))
 		return nullptr;
 
+	auto clone = Get(ShadowManager, CloneId);
 	if(!clone)
 	{
-		//get the original object (clone 0)
-		auto original = Get(ShadowManager);
-		if(ensure(original))
-		{
-			//create the clone
-			clone = DuplicateObject(original, original);
+		clone = CreateCloneObject(ShadowManager);
+		if(clone)
 			AddClone(clone, CloneId);
-		}
 	}
 
 	return clone;
 }
 
+int32 UArticyCloneableObject::CloneDelta(int32 CloneId)
+{
+	if(HasClone(CloneId))
+		return INDEX_NONE;
+
+	CloneId = AllocateCloneId(CloneId);
+	DeltaClones.Add(CloneId, MakeShared<FArticyCloneDelta>());
+	return CloneId;
+}
+
+bool UArticyCloneableObject::GetCloneProperty(const IShadowStateManager* ShadowManager, int32 CloneId, const FName& Property, ExpressoType& OutValue) const
+{
+	if(auto delta = DeltaClones.Find(CloneId))
+	{
+		if(auto value = (*delta)->Overrides.Find(Property))
+		{
+			OutValue = *value;
+			return true;
+		}
+
+		//not overridden, read it from the original
+		CloneId = 0;
+	}
+
+	auto object = Get(ShadowManager, CloneId);
+	if(!object)
+		return false;
+
+	OutValue = ExpressoType(object, Property.ToString());
+	return true;
+}
+
+bool UArticyCloneableObject::SetCloneProperty(const IShadowStateManager* ShadowManager, int32 CloneId, const FName& Property, const ExpressoType& Value)
+{
+	//shadow states and the change journal work on objects, so the delta clone is materialized in these cases
+	auto delta = DeltaClones.Find(CloneId);
+	if(delta && ShadowManager->GetShadowLevel() == 0 && !FArticyChangeJournal::GetActive())
+	{
+		//make sure the property exists, otherwise this would only fail once the clone is materialized
+		//overridden properties were already checked when they were set the first time
+		if(!(*delta)->Overrides.Contains(Property))
+		{
+			FString propertyName = Property.ToString();
+			auto target = ExpressoType::TryFeatureReroute(Get(ShadowManager), propertyName);
+			if(!ensureMsgf(target && target->GetProperty(*propertyName), TEXT("Property %s not found on object %s!"), *Property.ToString(), *GetName()))
+				return false;
+		}
+
+		(*delta)->Overrides.Add(Property, Value);
+		return true;
+	}
+
+	auto object = Get(ShadowManager, CloneId);
+	if(!object)
+		return false;
+
+	Value.SetValue(object, Property.ToString());
+	return true;
+}
+
 void UArticyCloneableObject::AddClone(UArticyObject* Clone, int32 CloneId)
 {
 	if(!ensure(Clone))
 		return;
 
+	CloneId = AllocateCloneId(CloneId);
+	Clones.Add(CloneId, FArticyShadowableObject{ Clone, CloneId });
+}
+
+int32 UArticyCloneableObject::AllocateCloneId(int32 CloneId)
+{
 	if(CloneId == -1)
 	{
-		//find the first free clone id
-		for(int i = 0; i != -1; ++i)
+		//take the lowest released clone id, they are all below NextCloneId
+		if(FreeCloneIds.Num() > 0)
 		{
-			if(!Clones.Find(i))
-			{
-				CloneId = i;
-				break;
-			}
+			FreeCloneIds.HeapPop(CloneId);
+			return CloneId;
 		}
+
+		//otherwise the next unused one, ids at or above NextCloneId might have been used explicitly
+		while(HasClone(NextCloneId))
+			++NextCloneId;
+		return NextCloneId++;
 	}
 
-	Clones.Add(CloneId, FArticyShadowableObject{ Clone, CloneId });
+	const int32 index = FreeCloneIds.Find(CloneId);
+	if(index != INDEX_NONE)
+		FreeCloneIds.HeapRemoveAt(index);
+
+	return CloneId;
+}
+
+void UArticyCloneableObject::FreeCloneId(int32 CloneId)
+{
+	//ids at or above NextCloneId are found by AllocateCloneId as soon as they are unused
+	if(CloneId < NextCloneId)
+		FreeCloneIds.HeapPush(CloneId);
+}
+
+UArticyObject* UArticyCloneableObject::CreateCloneObject(const IShadowStateManager* ShadowManager)
+{
+	//get the original object (clone 0)
+	auto original = Get(ShadowManager);
+	if(!ensure(original))
+		return nullptr;
+
+	//reuse a released clone if possible, otherwise create the clone
+	if(PooledClones.Num() > 0)
+	{
+		UArticyObject* clone = PooledClones.Pop();
+		ResetFromSource(clone, original);
+		return clone;
+	}
+
+	return DuplicateObject(original, original);
+}
+
+void UArticyCloneableObject::MaterializeDeltaClone(const IShadowStateManager* ShadowManager, int32 CloneId)
+{
+	TSharedPtr<FArticyCloneDelta> delta;
+	if(!DeltaClones.RemoveAndCopyValue(CloneId, delta))
+		return;
+
+	UArticyObject* clone = CreateCloneObject(ShadowManager);
+	if(!clone)
+		return;
+
+	{
+		//applying the overrides is not a change made by a script
+		FArticyJournalScope noJournal(nullptr, 0, nullptr, nullptr);
+		for(const auto& pair : delta->Overrides)
+			pair.Value.SetValue(clone, pair.Key.ToString());
+	}
+
+	//the clone id is already allocated
+	Clones.Add(CloneId, FArticyShadowableObject{ clone, CloneId });
+}
+
+bool UArticyCloneableObject::ReleaseClone(int32 CloneId)
+{
+	if(!ensureMsgf(CloneId != 0, TEXT("The original object (clone 0) can't be released.")))
+		return false;
+
+	if(DeltaClones.Remove(CloneId) > 0)
+	{
+		FreeCloneId(CloneId);
+		return true;
+	}
+
+	auto info = Clones.Find(CloneId);
+	if(!info)
+		return false;
+
+	//the shadow state removes its copy when it is popped, which requires the entry to stay alive
+	if(!ensureMsgf(!info->HasShadowCopies(), TEXT("Cannot release clone %d while a shadow state is active."), CloneId))
+		return false;
+
+	UArticyObject* clone = info->Get(nullptr, true);
+	Clones.Remove(CloneId);
+	FreeCloneId(CloneId);
+
+	if(clone && PooledClones.Num() < MaxPooledClones)
+		PooledClones.Add(clone);
+
+	return true;
 }
 
 //---------------------------------------------------------------------------//
 
 void UArticyDatabase::Init()
 {
+	//a runtime instance is a duplicate, which has the loaded objects but not their indexes and package counts
+	RebuildIndexes();
 	LoadDefaultPackages();
 }
 
 UArticyDatabase* UArticyDatabase::Get(const UObject* WorldContext)
 {
+	//objects of a runtime database (like nodes and pins) find it in their outer chain, without resolving the world
+	if(WorldContext)
+	{
+		auto outerDb = WorldContext->GetTypedOuter<UArticyDatabase>();
+		if(outerDb && !outerDb->IsAsset())
+			return outerDb;
+	}
+
+	auto world = GEngine->GetWorldFromContextObjectChecked(WorldContext);
+	if(!ensureMsgf(world, TEXT("Could not get world from WorldContext %s"), WorldContext ? *WorldContext->GetName() : TEXT("NULL")))
+		return nullptr;
+
+	//in a game, the database is owned by the subsystem of the game instance
+	if(auto subsystem = UArticySubsystem::Get(world))
+		return subsystem->GetDatabase(world);
+
 	bool bKeepBetweenWorlds = UArticyPluginSettings::Get()->bKeepDatabaseBetweenWorlds;
 
 	if(bKeepBetweenWorlds && PersistentClone.IsValid())
@@ -128,10 +408,6 @@ UArticyDatabase* UArticyDatabase::Get(const UObject* WorldContext)
 	//remove all clones who's world died (world == nullptr)
 	Clones.Remove(nullptr);
 
-	auto world = GEngine->GetWorldFromContextObjectChecked(WorldContext);
-	if(!ensureMsgf(world, TEXT("Could not get world from WorldContext %s"), WorldContext ? *WorldContext->GetName() : TEXT("NULL")))
-		return nullptr;
-
 	//find either the persistent clone or the clone that belongs to the world of the passed in context object
 	auto& clone = bKeepBetweenWorlds ? PersistentClone : Clones.FindOrAdd(world);
 
@@ -140,34 +416,46 @@ UArticyDatabase* UArticyDatabase::Get(const UObject* WorldContext)
 		//clone not valid, create a new one
 		UE_LOG(LogTemp, Warning, TEXT("Cloning ArticyDatabase."))
 
-		//get the original asset to clone from
-		auto asset = GetOriginal();
-		if(!asset)
-			return nullptr;
-
-		//duplicate the original asset
-		if(bKeepBetweenWorlds)
-		{
-			clone = DuplicateObject((UArticyDatabase*)asset, world->GetGameInstance());
+		clone = CreateRuntimeInstance(bKeepBetweenWorlds ? static_cast<UObject*>(world->GetGameInstance()) : static_cast<UObject*>(world));
 #if !WITH_EDITOR
+		if(bKeepBetweenWorlds && clone.IsValid())
 			clone->AddToRoot();
 #endif
-		}
-		else
-		{
-			clone = DuplicateObject((UArticyDatabase*)asset, world);
-		}
-
-		//make the clone load its default packages
-		if(clone.IsValid())
-			clone->Init();
 	}
 
 	return clone.Get();
 }
 
+UArticyDatabase* UArticyDatabase::CreateRuntimeInstance(UObject* Outer)
+{
+	//get the original asset to clone from
+	auto asset = GetOriginal();
+	if(!asset)
+		return nullptr;
+
+	//duplicate the original asset, and make the clone load its default packages
+	auto clone = DuplicateObject(const_cast<UArticyDatabase*>(asset), Outer);
+	if(clone)
+	{
+		//the loaded packages are transient, but the clone has all their objects
+		clone->LoadedPackages = asset->LoadedPackages;
+		clone->Init();
+	}
+
+	return clone;
+}
+
 void UArticyDatabase::UnloadDatabase()
 {
+	if (auto subsystem = UArticySubsystem::Get(this))
+	{
+		if (subsystem->ReleaseDatabase(this))
+		{
+			ConditionalBeginDestroy();
+			return;
+		}
+	}
+
 	bool bKeepBetweenWorlds = UArticyPluginSettings::Get()->bKeepDatabaseBetweenWorlds;
 
 	TWeakObjectPtr<UArticyDatabase>* dbPtr = nullptr;
@@ -266,11 +554,13 @@ void UArticyDatabase::LoadAllPackages(bool bDefaultOnly)
 	}
 }
 
-void UArticyDatabase::LoadPackage(FString PackageName)
+void UArticyDatabase::LoadPackage(FString PackageName, bool bLoadMediaBundle)
 {	
 	if (LoadedPackages.Contains(PackageName))
 	{
 		UE_LOG(LogArticyRuntime, Log, TEXT("Package %s already loaded."), *PackageName);
+		if (bLoadMediaBundle && !LoadedPackageMedia.Contains(PackageName) && ImportedPackages.FindRef(PackageName))
+			LoadPackageMedia(ImportedPackages[PackageName]);
 		return;
 	}
 	
@@ -297,6 +587,13 @@ void UArticyDatabase::LoadPackage(FString PackageName)
 	{
 		auto id = FArticyId(ArticyObject->GetId());
 
+		// objects exported to several packages are loaded once, and stay loaded until all of these packages are unloaded
+		if (int32* packageCount = LoadedObjectPackageCounts.Find(id))
+		{
+			++(*packageCount);
+			continue;
+		}
+
 		if (!ensureMsgf(!LoadedObjectsById.Contains(id), TEXT("Object with id [%d,%d] already in list!"), id.High, id.Low))
 			continue;
 
@@ -305,15 +602,23 @@ void UArticyDatabase::LoadPackage(FString PackageName)
 		CloneContainer->Init(InitialClone);
 		
 		LoadedObjectsById.Add(id, CloneContainer);
+		LoadedObjectPackageCounts.Add(id, 1);
 
-		if (!ArticyObject->GetTechnicalName().ToString().IsEmpty())
+		const FName& technicalName = ArticyObject->GetTechnicalName();
+		if (!technicalName.IsNone())
 		{
-			LoadedObjectsByName.FindOrAdd(ArticyObject->GetTechnicalName()).Objects.Add(CloneContainer);
+			LoadedObjectsByName.FindOrAdd(technicalName).Objects.Add(CloneContainer);
 		}
+
+		AddToIndexes(CloneContainer, InitialClone);
 	}
 
 	LoadedPackages.Add(PackageName);
+	InvalidateObjectLookups();
 	UE_LOG(LogArticyRuntime, Log, TEXT("Package %s loaded successfully."), *PackageName);
+
+	if (bLoadMediaBundle)
+		LoadPackageMedia(Package);
 }
 
 bool UArticyDatabase::UnloadPackage(const FString PackageName, const bool bQuickUnload)
@@ -332,46 +637,43 @@ bool UArticyDatabase::UnloadPackage(const FString PackageName, const bool bQuick
 
 	UArticyPackage* Package = ImportedPackages[PackageName];	
 
-	for(auto ArticyObject : Package->GetAssets())
+	for (auto ArticyObject : Package->GetAssets())
 	{
-		FArticyId ArticyId = ArticyObject->GetId();
-		FName TechnicalName = ArticyObject->GetTechnicalName();
+		const FArticyId ArticyId = ArticyObject->GetId();
 
-		bool bShouldUnload = false;
-		if(bQuickUnload)
+		int32* packageCount = LoadedObjectPackageCounts.Find(ArticyId);
+		if (!packageCount)
 		{
-			bShouldUnload = true;
+			// already removed by a quick unload of another package containing it
+			continue;
 		}
-		else
-		{
-			/*
-			 *	An exported object can exist multiple times in different packages
-			 *  In the database, there can only be one object with the same Id, so if we are unloading slowly, check if the object is contained in another package first
-			 *  Only unload if it is not contained in any other package
-			*/
-			bool bIsAssetContained = false;
-			for(FString LoadedPackageName : LoadedPackages)
-			{
-				if (!LoadedPackageName.Equals(Package->Name))
-				{
-					bIsAssetContained = bIsAssetContained || ImportedPackages[LoadedPackageName]->GetAssetsDict().Contains(TechnicalName);
-				}
-			}
 
-			if(!bIsAssetContained)
-			{
-				bShouldUnload = true;
-			}
-		}
+		// a quick unload removes the object even if other loaded packages contain it
+		if (!bQuickUnload && --(*packageCount) > 0)
+			continue;
+
+		LoadedObjectPackageCounts.Remove(ArticyId);
+
+		UArticyCloneableObject* container = nullptr;
+		if (!LoadedObjectsById.RemoveAndCopyValue(ArticyId, container))
+			continue;
+
+		RemoveFromIndexes(container, ArticyObject);
 
-		if(bShouldUnload)
+		// other objects might share the technical name
+		const FName& TechnicalName = ArticyObject->GetTechnicalName();
+		if (auto arr = LoadedObjectsByName.Find(TechnicalName))
 		{
-			LoadedObjectsById.FindAndRemoveChecked(ArticyId);
-			LoadedObjectsByName.FindAndRemoveChecked(TechnicalName);
+			arr->Objects.Remove(container);
+			if (arr->Objects.Num() == 0)
+				LoadedObjectsByName.Remove(TechnicalName);
 		}
 	}
 
 	LoadedPackages.Remove(Package->Name);
+	UnloadPackageMedia(PackageName);
+	InvalidateObjectLookups();
+	PruneFormattedTexts();
 	UE_LOG(LogArticyRuntime, Log, TEXT("Package %s unloaded successfully."), *PackageName);
 
 	return true;
@@ -379,9 +681,135 @@ bool UArticyDatabase::UnloadPackage(const FString PackageName, const bool bQuick
 
 void UArticyDatabase::UnloadAllPackages()
 {
+	TArray<FString> packagesWithMedia;
+	LoadedPackageMedia.GetKeys(packagesWithMedia);
+	for (const auto& packageName : packagesWithMedia)
+		UnloadPackageMedia(packageName);
+
 	LoadedPackages.Reset();
 	LoadedObjectsById.Reset();
 	LoadedObjectsByName.Reset();
+	LoadedObjectPackageCounts.Reset();
+	ObjectsByClass.Reset();
+	ObjectsByParent.Reset();
+	FormattedTexts.Reset();
+	InvalidateObjectLookups();
+}
+
+void UArticyDatabase::LoadPackageMedia(const UArticyPackage* Package)
+{
+	if (!UAssetManager::IsValid())
+	{
+		UE_LOG(LogArticyRuntime, Warning, TEXT("Cannot load the media of package %s, there is no asset manager."), *Package->Name);
+		return;
+	}
+
+	auto& assetManager = UAssetManager::Get();
+	const FPrimaryAssetId assetId = Package->GetPrimaryAssetId();
+
+	// packages are only known to the asset manager if their type is set up in the project settings, otherwise they are registered here
+	FPrimaryAssetTypeInfo typeInfo;
+	if (!assetManager.GetPrimaryAssetTypeInfo(assetId.PrimaryAssetType, typeInfo))
+		assetManager.ScanPathForPrimaryAssets(assetId.PrimaryAssetType, ArticyHelpers::GetArticyGeneratedFolder(), UArticyPackage::StaticClass(), false);
+
+	assetManager.LoadPrimaryAsset(assetId, { UArticyPackage::GetMediaBundleName() });
+	LoadedPackageMedia.Add(Package->Name, assetId);
+}
+
+void UArticyDatabase::UnloadPackageMedia(const FString& PackageName)
+{
+	FPrimaryAssetId assetId;
+	if (LoadedPackageMedia.RemoveAndCopyValue(PackageName, assetId) && UAssetManager::IsValid())
+		UAssetManager::Get().UnloadPrimaryAsset(assetId);
+}
+
+void UArticyDatabase::AddToIndexes(UArticyCloneableObject* Container, const UArticyObject* Object)
+{
+	if (!Container || !Object)
+		return;
+
+	for (const UClass* cls = Object->GetClass(); cls; cls = cls->GetSuperClass())
+	{
+		ObjectsByClass.FindOrAdd(cls).Add(Container);
+		for (const FImplementedInterface& feature : cls->Interfaces)
+			ObjectsByClass.FindOrAdd(feature.Class).Add(Container);
+
+		if (cls == UArticyObject::StaticClass())
+			break;
+	}
+
+	const FArticyId parent = Object->GetParentID();
+	if (!parent.IsNull())
+		ObjectsByParent.FindOrAdd(parent).Add(Container);
+}
+
+void UArticyDatabase::RebuildIndexes()
+{
+	ObjectsByClass.Reset();
+	ObjectsByParent.Reset();
+	LoadedObjectPackageCounts.Reset();
+
+	for (const auto& pair : LoadedObjectsById)
+	{
+		if (pair.Value)
+			AddToIndexes(pair.Value, pair.Value->Get(this, 0, /*bForceUnshadowed = */ true));
+	}
+
+	for (const auto& packageName : LoadedPackages)
+	{
+		const auto package = ImportedPackages.FindRef(packageName);
+		if (!package)
+			continue;
+
+		for (auto ArticyObject : package->GetAssets())
+		{
+			const FArticyId id = ArticyObject->GetId();
+			if (LoadedObjectsById.Contains(id))
+				++LoadedObjectPackageCounts.FindOrAdd(id);
+		}
+	}
+}
+
+void UArticyDatabase::RemoveFromIndexes(UArticyCloneableObject* Container, const UArticyObject* Object)
+{
+	if (!Container || !Object)
+		return;
+
+	for (const UClass* cls = Object->GetClass(); cls; cls = cls->GetSuperClass())
+	{
+		if (auto bucket = ObjectsByClass.Find(cls))
+			bucket->Remove(Container);
+		for (const FImplementedInterface& feature : cls->Interfaces)
+		{
+			if (auto bucket = ObjectsByClass.Find(feature.Class))
+				bucket->Remove(Container);
+		}
+
+		if (cls == UArticyObject::StaticClass())
+			break;
+	}
+
+	if (auto children = ObjectsByParent.Find(Object->GetParentID()))
+	{
+		children->Remove(Container);
+		if (children->Num() == 0)
+			ObjectsByParent.Remove(Object->GetParentID());
+	}
+}
+
+void UArticyDatabase::GetIndexedObjects(const UClass* Class, int32 CloneId, TArray<UArticyObject*>& OutObjects) const
+{
+	auto bucket = ObjectsByClass.Find(Class);
+	if (!bucket)
+		return;
+
+	OutObjects.Reserve(OutObjects.Num() + bucket->Num());
+	for (auto container : *bucket)
+	{
+		auto obj = container->Get(this, CloneId, /*bForceUnshadowed = */ true);
+		if (obj && obj->GetCloneId() == CloneId)
+			OutObjects.Add(obj);
+	}
 }
 
 void UArticyDatabase::SetExpressoScriptsClass(TSubclassOf<UArticyExpressoScripts> NewClass)
@@ -511,6 +939,87 @@ UArticyObject* UArticyDatabase::GetObjectByName(FName TechnicalName, int32 Clone
 	return info? Cast<UArticyObject>(info->Get(this, CloneId)) : nullptr;
 }
 
+UArticyObject* UArticyDatabase::GetObject(const FArticyObjectHandle& Handle) const
+{
+	const uint32 generation = GetObjectLookupGeneration();
+	if (Handle.Generation != generation)
+	{
+		Handle.Container = nullptr;
+		Handle.Generation = generation;
+
+		if (Handle.Name.IsNone())
+		{
+			if (UArticyCloneableObject* const* info = LoadedObjectsById.Find(Handle.Id))
+				Handle.Container = *info;
+		}
+		else if (auto arr = LoadedObjectsByName.Find(Handle.Name))
+		{
+			// like GetObjectByName, take the first matching object
+			if (arr->Objects.Num() > 0)
+				Handle.Container = arr->Objects[0];
+		}
+	}
+
+	// the container is cached, not the object, so shadow states and clones created later are respected
+	return Handle.Container ? Handle.Container->Get(this, Handle.CloneId) : nullptr;
+}
+
+uint32 UArticyDatabase::GetObjectLookupGeneration() const
+{
+	if (ObjectLookupGeneration == 0)
+	{
+		// 0 is never used, it marks handles which were not resolved yet
+		if (++NextObjectLookupGeneration == 0)
+			++NextObjectLookupGeneration;
+		ObjectLookupGeneration = NextObjectLookupGeneration;
+	}
+
+	return ObjectLookupGeneration;
+}
+
+FText UArticyDatabase::GetFormattedText(const IArticyObjectWithText* Object) const
+{
+	if (!ensure(Object))
+		return FText::GetEmpty();
+
+	// shadow copies and clones come and go, so the cache is pruned whenever it doubled in size
+	if (FormattedTexts.Num() >= FormattedTextsPruneSize)
+	{
+		PruneFormattedTexts();
+		FormattedTextsPruneSize = FMath::Max(64, FormattedTexts.Num() * 2);
+	}
+
+	const FText& text = Object->GetText();
+	auto& formatted = FormattedTexts.FindOrAdd(Object->_getUObject());
+
+	// the source is compared by value, as the text changes if the culture does
+	const FString& source = text.ToString();
+	if (!formatted.Template.GetSource().Equals(source, ESearchCase::CaseSensitive))
+		formatted.Template.Parse(source);
+
+	if (!formatted.Template.HasTokens())
+		return text;
+
+	bool bChanged;
+	const FString& rendered = formatted.Template.Render(this, &bChanged);
+	if (bChanged)
+		formatted.Text = FText::FromString(rendered);
+
+	return formatted.Text;
+}
+
+void UArticyDatabase::PruneFormattedTexts() const
+{
+	for (auto it = FormattedTexts.CreateIterator(); it; ++it)
+	{
+		// objects which are not articy objects (or features of them) are kept as long as they exist
+		const UObject* object = it->Key.ResolveObjectPtr();
+		const UArticyObject* articyObject = object ? Cast<UArticyObject>(object) : nullptr;
+		if (!object || (articyObject && !LoadedObjectsById.Contains(articyObject->GetId())))
+			it.RemoveCurrent();
+	}
+}
+
 UArticyObject* UArticyDatabase::GetObjectFromStringRepresentation(FString StringID_CloneID, TSubclassOf<class UArticyObject> CastTo) const
 {
 	FString StringId,CloneId;
@@ -525,17 +1034,84 @@ TArray<UArticyObject*> UArticyDatabase::GetObjects(FName TechnicalName, int32 Cl
 	return GetObjects<UArticyObject>(TechnicalName, CloneId);
 }
 
+TArray<FName> UArticyDatabase::FindNamesWithPrefix(const FString& Prefix, int32 MaxResults) const
+{
+	TArray<FName> names;
+	GetNameIndex().FindWithPrefix(Prefix, names, MaxResults);
+	return names;
+}
+
+TArray<UArticyObject*> UArticyDatabase::GetObjectsWithNamePrefix(const FString& Prefix, int32 CloneId) const
+{
+	TArray<FName> names;
+	GetNameIndex().FindWithPrefix(Prefix, names);
+
+	TArray<UArticyObject*> arr;
+	for (const FName& name : names)
+	{
+		for (auto container : LoadedObjectsByName.FindChecked(name).Objects)
+		{
+			if (auto obj = container->Get(this, CloneId))
+				arr.Add(obj);
+		}
+	}
+	return arr;
+}
+
+TArray<FName> UArticyDatabase::FindSimilarNames(const FString& Name, int32 MaxDistance, int32 MaxResults) const
+{
+	TArray<FArticyNameMatch> matches;
+	GetNameIndex().FindFuzzy(Name, MaxDistance, matches, MaxResults);
+
+	TArray<FName> names;
+	names.Reserve(matches.Num());
+	for (const auto& match : matches)
+		names.Add(match.Name);
+	return names;
+}
+
+const FArticyNameIndex& UArticyDatabase::GetNameIndex() const
+{
+	// rebuilt on demand, so loading several packages in a row only builds it once
+	const uint32 generation = GetObjectLookupGeneration();
+	if (NameIndexGeneration != generation)
+	{
+		TArray<FName> names;
+		LoadedObjectsByName.GenerateKeyArray(names);
+		NameIndex.Build(names);
+		NameIndexGeneration = generation;
+	}
+
+	return NameIndex;
+}
+
 TArray<UArticyObject*> UArticyDatabase::GetObjectsOfClass(TSubclassOf<class UArticyObject> Type, int32 CloneId) const
 {
 	TArray<UArticyObject*> arr;
-	TArray<UArticyCloneableObject*> Objects;
-	LoadedObjectsById.GenerateValueArray(Objects);
+	GetIndexedObjects(Type, CloneId, arr);
+	return arr;
+}
 
-	for (auto ClonableObject : Objects)
+TArray<UArticyObject*> UArticyDatabase::GetObjectsWithFeature(TSubclassOf<UInterface> Feature, int32 CloneId) const
+{
+	TArray<UArticyObject*> arr;
+	GetIndexedObjects(Feature, CloneId, arr);
+	return arr;
+}
+
+TArray<UArticyObject*> UArticyDatabase::GetChildrenOf(FArticyId ParentId, int32 CloneId) const
+{
+	TArray<UArticyObject*> arr;
+
+	auto children = ObjectsByParent.Find(ParentId);
+	if (!children)
+		return arr;
+
+	arr.Reserve(children->Num());
+	for (auto container : *children)
 	{
-		auto obj = ClonableObject->Get(this, CloneId, /*bForceUnshadowed = */ true);
-		if (obj && (obj->GetCloneId() == CloneId) && obj->IsA(Type))
-			arr.Add(Cast<UArticyObject>(obj));
+		if (auto obj = container->Get(this, CloneId))
+			arr.Add(obj);
 	}
 
 	return arr;
@@ -544,11 +1120,10 @@ TArray<UArticyObject*> UArticyDatabase::GetObjectsOfClass(TSubclassOf<class UArt
 TArray<UArticyObject*> UArticyDatabase::GetAllObjects() const
 {
 	TArray<UArticyObject*> arr;
-	TArray<UArticyCloneableObject*> Objects;
-	LoadedObjectsById.GenerateValueArray(Objects);
-	for (auto ClonableObject : Objects)
+	arr.Reserve(LoadedObjectsById.Num());
+	for (const auto& pair : LoadedObjectsById)
 	{
-		auto obj = ClonableObject->Get(this, 0, /*bForceUnshadowed = */ true);
+		auto obj = pair.Value->Get(this, 0, /*bForceUnshadowed = */ true);
 			arr.Add(obj);
 	}
 	return arr;
@@ -590,6 +1165,46 @@ UArticyObject* UArticyDatabase::GetOrCloneByName(const FName& TechnicalName, int
 	return info? Cast<UArticyObject>(info->Clone(this, NewCloneId, false)) : nullptr;
 }
 
+bool UArticyDatabase::ReleaseClone(FArticyId Id, int32 CloneId)
+{
+	auto info = LoadedObjectsById.Find(Id);
+	if (!info)
+		return false;
+
+	//the clone object is pooled and reused, so its formatted text is dropped with it
+	UArticyObject* clone = (*info)->IsDeltaClone(CloneId) ? nullptr : (*info)->Get(this, CloneId, true);
+	if (!(*info)->ReleaseClone(CloneId))
+		return false;
+
+	if (clone)
+		FormattedTexts.Remove(clone);
+	return true;
+}
+
+int32 UArticyDatabase::CloneDelta(FArticyId Id, int32 NewCloneId)
+{
+	auto info = LoadedObjectsById.Find(Id);
+	return info ? (*info)->CloneDelta(NewCloneId) : INDEX_NONE;
+}
+
+bool UArticyDatabase::IsDeltaClone(FArticyId Id, int32 CloneId) const
+{
+	auto info = LoadedObjectsById.Find(Id);
+	return info && (*info)->IsDeltaClone(CloneId);
+}
+
+bool UArticyDatabase::GetCloneProperty(FArticyId Id, int32 CloneId, const FName& Property, ExpressoType& OutValue) const
+{
+	auto info = LoadedObjectsById.Find(Id);
+	return info && (*info)->GetCloneProperty(this, CloneId, Property, OutValue);
+}
+
+bool UArticyDatabase::SetCloneProperty(FArticyId Id, int32 CloneId, const FName& Property, const ExpressoType& Value)
+{
+	auto info = LoadedObjectsById.Find(Id);
+	return info && (*info)->SetCloneProperty(this, CloneId, Property, Value);
+}
+
 UArticyExpressoScripts* UArticyDatabase::GetExpressoInstance() const
 {
 	if(!CachedExpressoScripts)
@@ -604,6 +1219,54 @@ UArticyExpressoScripts* UArticyDatabase::GetExpressoInstance() const
 	return CachedExpressoScripts;
 }
 
+void UArticyDatabase::EvaluateConditionsBatch(TArrayView<IArticyConditionProvider* const> Conditions, UArticyGlobalVariables* GV, UObject* MethodProvider, TArray<bool>& OutResults)
+{
+	OutResults.Init(true, Conditions.Num());
+	if (!GV)
+		GV = GetGVs();
+
+	// conditions with a script are evaluated together, the others one by one
+	TArray<int32, TInlineAllocator<64>> hashes;
+	TArray<int32, TInlineAllocator<64>> indices;
+	for (int32 i = 0; i < Conditions.Num(); ++i)
+	{
+		int32 hash;
+		if (Conditions[i] && Conditions[i]->GetConditionHash(hash))
+		{
+			hashes.Add(hash);
+			indices.Add(i);
+		}
+	}
+
+	TArray<bool, TInlineAllocator<64>> results;
+	results.SetNumUninitialized(hashes.Num());
+	GetExpressoInstance()->EvaluateBatch(hashes, GV, MethodProvider, results);
+
+	for (int32 i = 0; i < indices.Num(); ++i)
+		OutResults[indices[i]] = results[i];
+
+	if (indices.Num() == Conditions.Num())
+		return;
+
+	for (int32 i = 0, next = 0; i < Conditions.Num(); ++i)
+	{
+		if (next < indices.Num() && indices[next] == i)
+			++next;
+		else if (Conditions[i])
+			OutResults[i] = Conditions[i]->Evaluate(GV, MethodProvider);
+	}
+}
+
+void UArticyDatabase::EvaluateConditions(const TArray<UObject*>& Conditions, UArticyGlobalVariables* GV, UObject* MethodProvider, TArray<bool>& OutResults)
+{
+	TArray<IArticyConditionProvider*, TInlineAllocator<64>> conditions;
+	conditions.Reserve(Conditions.Num());
+	for (auto object : Conditions)
+		conditions.Add(Cast<IArticyConditionProvider>(object));
+
+	EvaluateConditionsBatch(conditions, GV, MethodProvider, OutResults);
+}
+
 UArticyDatabase::FAssetId UArticyDatabase::ResolveIDs(const FString& articyAssetFileName)
 {
 	FString fileName = FPaths::GetBaseFilename(articyAssetFileName);
@@ -618,4 +1281,5 @@ UArticyDatabase::FAssetId UArticyDatabase::ResolveIDs(const FString& articyAsset
 	return assetId;
 }
 TMap<TWeakObjectPtr<UWorld>, TWeakObjectPtr<UArticyDatabase>> UArticyDatabase::Clones;
-TWeakObjectPtr<UArticyDatabase> UArticyDatabase::PersistentClone;
\ No newline at end of file
+TWeakObjectPtr<UArticyDatabase> UArticyDatabase::PersistentClone;
+uint32 UArticyDatabase::NextObjectLookupGeneration = 0;
\ No newline at end of file
@@ -0,0 +1,266 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "ArticyDialogueHistory.h"
+#include "ArticyFlowPlayer.h"
+#include "ArticyDatabase.h"
+#include "ArticyPrimitive.h"
+#include "Interfaces/ArticyFlowObject.h"
+#include "Interfaces/ArticyObjectWithSpeaker.h"
+
+void UArticyDialogueHistoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!FlowPlayer && GetOwner())
+		FlowPlayer = GetOwner()->FindComponentByClass<UArticyFlowPlayer>();
+
+	BindFlowPlayer();
+
+	// the flow player may have begun play first, and already paused on its start node
+	if (FlowPlayer && FlowPlayer->GetCursor() && FlowPlayer->ShouldPauseOn(FlowPlayer->GetCursor()))
+		OnPlayerPaused(FlowPlayer->GetCursor());
+}
+
+void UArticyDialogueHistoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnbindFlowPlayer();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UArticyDialogueHistoryComponent::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	if (Ar.IsLoading())
+	{
+		// the loaded entries replaced the previous ones, which might still have list items
+		NextSequence += Count;
+		ListItems.Reset();
+		bBranchPlayed = true;
+	}
+}
+
+void UArticyDialogueHistoryComponent::SetFlowPlayer(UArticyFlowPlayer* NewFlowPlayer)
+{
+	if (NewFlowPlayer == FlowPlayer)
+		return;
+
+	UnbindFlowPlayer();
+	FlowPlayer = NewFlowPlayer;
+	bBranchPlayed = true;
+
+	if (HasBegunPlay())
+		BindFlowPlayer();
+}
+
+void UArticyDialogueHistoryComponent::SetCapacity(int32 NewCapacity)
+{
+	NewCapacity = FMath::Max(1, NewCapacity);
+	if (NewCapacity == Capacity)
+		return;
+
+	Capacity = NewCapacity;
+	if (Entries.Num() > 0)
+	{
+		RestoreEntries(GetEntries());
+	}
+}
+
+//---------------------------------------------------------------------------//
+
+void UArticyDialogueHistoryComponent::AddEntry(const FArticyDialogueHistoryEntry& Entry)
+{
+	// the ring is allocated on the first entry, or reallocated if the capacity was changed in the meantime
+	if (Entries.Num() != FMath::Max(1, Capacity))
+		RestoreEntries(GetEntries());
+
+	if (Count < Entries.Num())
+	{
+		Entries[(Head + Count) % Entries.Num()] = Entry;
+		++Count;
+	}
+	else
+	{
+		// the history is full, overwrite the oldest entry
+		Entries[Head] = Entry;
+		Head = (Head + 1) % Entries.Num();
+	}
+	++NextSequence;
+
+	OnHistoryChanged.Broadcast(this);
+}
+
+void UArticyDialogueHistoryComponent::Clear()
+{
+	Head = 0;
+	Count = 0;
+	bBranchPlayed = true;
+	ListItems.Reset();
+
+	OnHistoryChanged.Broadcast(this);
+}
+
+FArticyDialogueHistoryEntry UArticyDialogueHistoryComponent::GetEntry(int32 Index) const
+{
+	const auto entry = FindEntry(Index);
+	return entry ? *entry : FArticyDialogueHistoryEntry();
+}
+
+const FArticyDialogueHistoryEntry* UArticyDialogueHistoryComponent::FindEntry(const int32 Index) const
+{
+	if (Index < 0 || Index >= Count)
+		return nullptr;
+
+	return &Entries[(Head + Index) % Entries.Num()];
+}
+
+TArray<FArticyDialogueHistoryEntry> UArticyDialogueHistoryComponent::GetEntries() const
+{
+	TArray<FArticyDialogueHistoryEntry> entries;
+	entries.Reserve(Count);
+	for (int32 i = 0; i < Count; ++i)
+		entries.Add(*FindEntry(i));
+
+	return entries;
+}
+
+void UArticyDialogueHistoryComponent::RestoreEntries(const TArray<FArticyDialogueHistoryEntry>& NewEntries)
+{
+	const int32 capacity = FMath::Max(1, Capacity);
+	const int32 first = FMath::Max(0, NewEntries.Num() - capacity);
+
+	// NewEntries may be the result of GetEntries, so the ring is only changed after copying them
+	TArray<FArticyDialogueHistoryEntry> entries;
+	entries.SetNum(capacity);
+	for (int32 i = first; i < NewEntries.Num(); ++i)
+		entries[i - first] = NewEntries[i];
+
+	Entries = MoveTemp(entries);
+	Head = 0;
+	Count = NewEntries.Num() - first;
+	bBranchPlayed = true;
+
+	// the restored entries are new entries, so they don't get the items of the previous ones
+	NextSequence += Count;
+	ListItems.Reset();
+
+	OnHistoryChanged.Broadcast(this);
+}
+
+void UArticyDialogueHistoryComponent::GetListItems(TArray<UObject*>& OutItems)
+{
+	// the items of entries which were overwritten are dropped, a list view would keep showing their old entry otherwise
+	const int64 firstSequence = NextSequence - Count;
+	int32 numRemoved = 0;
+	while (numRemoved < ListItems.Num() && ListItems[numRemoved]->Sequence < firstSequence)
+		++numRemoved;
+	ListItems.RemoveAt(0, numRemoved);
+
+	for (int64 sequence = firstSequence + ListItems.Num(); sequence < NextSequence; ++sequence)
+	{
+		auto item = NewObject<UArticyDialogueHistoryItem>(this);
+		item->Sequence = sequence;
+		ListItems.Add(item);
+	}
+
+	OutItems.Reset(ListItems.Num());
+	OutItems.Append(ListItems);
+}
+
+//---------------------------------------------------------------------------//
+
+void UArticyDialogueHistoryComponent::OnPlayerPaused(TScriptInterface<IArticyFlowObject> PausedOn)
+{
+	auto node = Cast<UArticyPrimitive>(PausedOn.GetObject());
+	if (!node)
+		return;
+
+	// the player pauses again on the same node when the branches are updated
+	const auto last = FindEntry(Count - 1);
+	if (!bBranchPlayed && last && last->Node == node->GetId() && last->CloneId == static_cast<int32>(node->GetCloneId()))
+		return;
+
+	FArticyDialogueHistoryEntry entry;
+	entry.Node = node->GetId();
+	entry.CloneId = static_cast<int32>(node->GetCloneId());
+	entry.Timestamp = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
+
+	if (auto withSpeaker = Cast<IArticyObjectWithSpeaker>(node))
+		entry.Speaker = withSpeaker->GetSpeakerId();
+
+	bBranchPlayed = false;
+	AddEntry(entry);
+}
+
+void UArticyDialogueHistoryComponent::OnBranchPlayed(UArticyFlowPlayer* Player, const FArticyBranch& Branch)
+{
+	if (Count > 0)
+		Entries[(Head + Count - 1) % Entries.Num()].BranchIndex = Branch.Index;
+
+	bBranchPlayed = true;
+}
+
+void UArticyDialogueHistoryComponent::BindFlowPlayer()
+{
+	if (!FlowPlayer)
+		return;
+
+	FlowPlayer->OnPlayerPaused.AddUniqueDynamic(this, &UArticyDialogueHistoryComponent::OnPlayerPaused);
+	BranchPlayedHandle = FlowPlayer->OnBranchPlayed().AddUObject(this, &UArticyDialogueHistoryComponent::OnBranchPlayed);
+}
+
+void UArticyDialogueHistoryComponent::UnbindFlowPlayer()
+{
+	if (!FlowPlayer)
+		return;
+
+	FlowPlayer->OnPlayerPaused.RemoveDynamic(this, &UArticyDialogueHistoryComponent::OnPlayerPaused);
+	FlowPlayer->OnBranchPlayed().Remove(BranchPlayedHandle);
+	BranchPlayedHandle.Reset();
+}
+
+//---------------------------------------------------------------------------//
+
+FArticyDialogueHistoryEntry UArticyDialogueHistoryItem::GetEntry() const
+{
+	const auto entry = FindEntry();
+	return entry ? *entry : FArticyDialogueHistoryEntry();
+}
+
+UArticyObject* UArticyDialogueHistoryItem::GetNode()
+{
+	const auto entry = FindEntry();
+	if (!CachedNode.IsValid() && entry && !entry->Node.IsNull())
+	{
+		auto db = UArticyDatabase::Get(this);
+		CachedNode = db ? db->GetObject(entry->Node, entry->CloneId) : nullptr;
+	}
+
+	return CachedNode.Get();
+}
+
+UArticyObject* UArticyDialogueHistoryItem::GetSpeaker()
+{
+	const auto entry = FindEntry();
+	if (!CachedSpeaker.IsValid() && entry && !entry->Speaker.IsNull())
+	{
+		auto db = UArticyDatabase::Get(this);
+		CachedSpeaker = db ? db->GetObject(entry->Speaker) : nullptr;
+	}
+
+	return CachedSpeaker.Get();
+}
+
+const FArticyDialogueHistoryEntry* UArticyDialogueHistoryItem::FindEntry() const
+{
+	auto history = Cast<UArticyDialogueHistoryComponent>(GetOuter());
+	if (!history)
+		return nullptr;
+
+	// entries which were overwritten or cleared are out of range
+	const int64 index = Sequence - (history->NextSequence - history->Count);
+	return index >= 0 && index < history->Count ? history->FindEntry(static_cast<int32>(index)) : nullptr;
+}
@@ -7,11 +7,103 @@
 #include "ArticyExpressoScripts.h"
 #include "ArticyRuntimeModule.h"
 #include "ArticyFlowPlayer.h"
+#include "ArticyGlobalVariables.h"
+#include "ArticyChangeJournal.h"
 
 TMap<FName, ExpressoType::Definition> ExpressoType::Definitions;
 
-ExpressoType::ExpressoType() {}
-ExpressoType::~ExpressoType() {}
+namespace
+{
+	/** Literals are compared case sensitive, unlike the default FString keys. */
+	struct FExpressoLiteralKeyFuncs : TDefaultMapKeyFuncs<FString, FExpressoString*, false>
+	{
+		static FORCEINLINE bool Matches(const FString& A, const FString& B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+		static FORCEINLINE uint32 GetKeyHash(const FString& Key) { return FCrc::StrCrc32(*Key); }
+	};
+
+	/**
+	 * The strings of all names and script literals used by expresso values. Both are a bounded set, so their strings
+	 * are never freed, and can be read without a lock once they are added.
+	 */
+	struct FExpressoNamePool
+	{
+		FExpressoNamePool()
+		{
+			Empty.bPooled = true;
+		}
+
+		FExpressoString* Intern(const FName& Name)
+		{
+			if (Name.IsNone())
+				return &Empty;
+
+			{
+				FReadScopeLock readLock(Lock);
+				if (FExpressoString* const* pooled = Strings.Find(Name))
+					return *pooled;
+			}
+
+			FWriteScopeLock writeLock(Lock);
+			if (FExpressoString* const* pooled = Strings.Find(Name))
+				return *pooled;
+
+			FExpressoString* pooled = new FExpressoString();
+			pooled->Value = Name.ToString();
+			pooled->bPooled = true;
+			Strings.Add(Name, pooled);
+			return pooled;
+		}
+
+		FExpressoString* InternLiteral(const FString& Literal)
+		{
+			if (Literal.IsEmpty())
+				return &Empty;
+
+			FWriteScopeLock writeLock(Lock);
+			if (FExpressoString* const* pooled = Literals.Find(Literal))
+				return *pooled;
+
+			FExpressoString* pooled = new FExpressoString();
+			pooled->Value = Literal;
+			pooled->bPooled = true;
+			Literals.Add(Literal, pooled);
+			return pooled;
+		}
+
+		/** The empty string, used for all empty string values. */
+		FExpressoString Empty;
+
+	private:
+		TMap<FName, FExpressoString*> Strings;
+		TMap<FString, FExpressoString*, FDefaultSetAllocator, FExpressoLiteralKeyFuncs> Literals;
+		FRWLock Lock;
+	};
+
+	FExpressoNamePool& GetNamePool()
+	{
+		static FExpressoNamePool Pool;
+		return Pool;
+	}
+}
+
+FExpressoString* ExpressoType::InternName(const FName& Name)
+{
+	return GetNamePool().Intern(Name);
+}
+
+FExpressoString* ExpressoType::InternLiteral(const FString& Literal)
+{
+	return GetNamePool().InternLiteral(Literal);
+}
+
+FExpressoLiteral::FExpressoLiteral(const TCHAR* Literal) : FString(Literal), String(ExpressoType::InternLiteral(*this))
+{
+}
+
+const FString& ExpressoType::GetString() const
+{
+	return Type == String ? StringValue->Value : GetNamePool().Empty.Value;
+}
 
 ExpressoType::ExpressoType(UArticyBaseObject* Object, const FString& Property)
 {
@@ -55,31 +147,44 @@ ExpressoType::ExpressoType(const double& Value)
 
 ExpressoType::ExpressoType(const FString& Value)
 {
-	StringValue = Value;
-	Type = String;
+	if (Value.IsEmpty())
+	{
+		SetString(&GetNamePool().Empty);
+		return;
+	}
+
+	FExpressoString* string = new FExpressoString();
+	string->Value = Value;
+	string->RefCount.Set(1);
+	SetString(string);
+}
+
+ExpressoType::ExpressoType(const FExpressoLiteral& Value)
+{
+	SetString(Value.String);
 }
 
 //========================================//
 
 ExpressoType::ExpressoType(const UArticyPrimitive* Object)
 {
-	Type = String;
+	Type = ObjectRef;
 
-	if (!Object)
+	// a null object is referenced by the null id
+	if (Object)
 	{
-		// Return "Null" ID to avoid crashes expecting this to be in the %11u_%d format
-		StringValue = "0_0";
-		return;
+		ObjectId = Object->GetId().Get();
+		CloneId = Object->GetCloneId();
 	}
-
-	// Make sure to use the full 64-bit ID
-	StringValue = FString::Printf(TEXT("%llu_%d"), Object->GetId().Get(), Object->GetCloneId());
 }
 
 ExpressoType::ExpressoType(const UArticyString& Value)
 {
-	Type = String;
-	StringValue = Value.Get();
+	// reading an unchanged variable only counts a reference to the string it was last read as
+	if (Value.ScriptValue.Type != String || !Value.ScriptValue.GetString().Equals(Value.Get(), ESearchCase::CaseSensitive))
+		Value.ScriptValue = ExpressoType(Value.Get());
+
+	CopyFrom(Value.ScriptValue);
 }
 
 ExpressoType::ExpressoType(const UArticyInt& Value)
@@ -94,20 +199,24 @@ ExpressoType::ExpressoType(const UArticyBool& Value)
 	BoolValue = Value.Get();
 }
 
-ExpressoType::ExpressoType(const FArticyId& Value)
+ExpressoType::ExpressoType(const UArticyFloat& Value)
 {
-	Type = String;
+	Type = Float;
+	FloatValue = Value.Get();
+}
 
-	if (!Value)
-	{
-		// Return "Null" ID to avoid crashes expecting this to be in the %11u_%d format
-		StringValue = "0_0";
-		return;
-	}
+ExpressoType::ExpressoType(const UArticyEnum& Value)
+{
+	// only literals compared with or assigned to the variable itself are compiled to indices,
+	// mixed with other script values the variable is compared by the name of its value
+	SetString(InternName(Value.GetValueName()));
+}
 
-	// Make sure to use the full 64-bit ID
-	// > always 0 for clone ID... PB...
-	StringValue = FString::Printf(TEXT("%llu_0"), Value.Get());
+ExpressoType::ExpressoType(const FArticyId& Value)
+{
+	// ids never reference a clone
+	Type = ObjectRef;
+	ObjectId = Value.Get();
 }
 
 ExpressoType::operator bool() const
@@ -118,13 +227,15 @@ ExpressoType::operator bool() const
 
 ExpressoType::operator int64() const
 {
-	ensure(Type == Float || Type == Int || Type == String);
+	ensure(Type == Float || Type == Int || Type == String || Type == ObjectRef);
+
+	if (Type == ObjectRef)
+		return ObjectId;
 
 	if (Type == String)
 	{
-		// If we're trying to cast a string to an int64, that likely means we're trying
-		//  to assign an ArticyId via an Articy Primitive (returned by getObj or the like).
-		// In that case, the string should be of the format 0xARTICYID_0xCLONEID
+		// Object references used to be stored as strings of the format ARTICYID_CLONEID,
+		// which is still accepted for strings coming from other sources.
 		// So, split the string along underscores (_)
 		TArray<FString> articyIds;
 		int32 numberOfParts = GetString().ParseIntoArray(articyIds, TEXT("_"), true);
@@ -158,7 +269,11 @@ ExpressoType::operator double() const
 
 ExpressoType::operator FString() const
 {
-	ensure(Type == String);
+	ensure(Type == String || Type == ObjectRef);
+
+	if (Type == ObjectRef)
+		return ToString();
+
 	return GetString();
 }
 
@@ -176,6 +291,10 @@ FString ExpressoType::ToString() const
 	if (Type == Float)
 		return FString::SanitizeFloat(GetFloat());
 
+	// Object references use the format ARTICYID_CLONEID, with the full 64-bit id
+	if (Type == ObjectRef)
+		return FString::Printf(TEXT("%llu_%d"), ObjectId, CloneId);
+
 	ensureMsgf(false, TEXT("Unknown ArticyExpressoType!"));
 	return FString();
 }
@@ -197,6 +316,8 @@ ExpressoType ExpressoType::operator-() const
 		return ExpressoType(-GetFloat());
 	case String:
 		return ExpressoType(FString(""));
+	case ObjectRef:
+		break;
 
 	default:
 		ensureMsgf(false, TEXT("Unknown ArticyExpressoType!"));
@@ -237,7 +358,23 @@ bool ExpressoType::operator==(const ExpressoType& Other) const
 			ensureMsgf(false, TEXT("Uncomparable expresso types!"));
 		}
 	case String:
+		// copies share their string, otherwise compare like FString does (ignoring case)
+		if (Other.Type == String && StringValue == Other.StringValue)
+			return true;
+		if (Other.Type == ObjectRef)
+			return GetString() == Other.ToString();
 		return GetString() == Other.GetString();
+	case ObjectRef:
+		switch (Other.Type)
+		{
+		case ObjectRef:
+			return ObjectId == Other.ObjectId && CloneId == Other.CloneId;
+		case String:
+			return ToString() == Other.GetString();
+		default:
+			ensureMsgf(false, TEXT("Uncomparable expresso types!"));
+		}
+		break;
 
 	default:
 		ensureMsgf(false, TEXT("Unknown ArticyExpressoType!"));
@@ -282,6 +419,9 @@ bool ExpressoType::operator<(const ExpressoType& Other) const
 		}
 	case String:
 		return GetString() < Other.GetString();
+	case ObjectRef:
+		ensureMsgf(false, TEXT("Object references cannot be ordered!"));
+		break;
 
 	default:
 		ensureMsgf(false, TEXT("Unknown ArticyExpressoType!"));
@@ -321,6 +461,9 @@ bool ExpressoType::operator>(const ExpressoType& Other) const
 		}
 	case String:
 		return GetString() > Other.GetString();
+	case ObjectRef:
+		ensureMsgf(false, TEXT("Object references cannot be ordered!"));
+		break;
 
 	default:
 		ensureMsgf(false, TEXT("Unknown ArticyExpressoType!"));
@@ -343,6 +486,7 @@ ExpressoType ExpressoType::operator&&(const ExpressoType& Other) const
 		return ExpressoType(GetFloat() && Other.GetFloat());
 
 	case String:
+	case ObjectRef:
 	case Undefined:
 		break;
 
@@ -365,6 +509,7 @@ ExpressoType ExpressoType::operator||(const ExpressoType& Other) const
 		return ExpressoType(GetFloat() || Other.GetFloat());
 
 	case String:
+	case ObjectRef:
 	case Undefined:
 		break;
 
@@ -386,6 +531,7 @@ ExpressoType ExpressoType::operator^(const ExpressoType& Other) const
 
 	case Float:
 	case String:
+	case ObjectRef:
 	case Undefined:
 		break;
 
@@ -410,7 +556,9 @@ ExpressoType ExpressoType::operator+(const ExpressoType& Other) const
 	case Float:
 		return ExpressoType(GetFloat() + Other.GetFloat());
 	case String:
-		return ExpressoType(GetString() + Other.GetString());
+		return ExpressoType(GetString() + (Other.Type == ObjectRef ? Other.ToString() : Other.GetString()));
+	case ObjectRef:
+		break;
 
 	default:
 		ensureMsgf(false, TEXT("Unknown ArticyExpressoType!"));
@@ -436,6 +584,7 @@ ExpressoType ExpressoType::operator*(const ExpressoType& Other) const
 		return ExpressoType(GetFloat() * Other.GetFloat());
 
 	case String:
+	case ObjectRef:
 	case Undefined:
 		break;
 
@@ -457,6 +606,7 @@ ExpressoType ExpressoType::operator/(const ExpressoType& Other) const
 
 	case Bool:
 	case String:
+	case ObjectRef:
 	case Undefined:
 		break;
 
@@ -479,6 +629,7 @@ ExpressoType ExpressoType::operator%(const ExpressoType& Other) const
 
 	case Bool:
 	case String:
+	case ObjectRef:
 	case Undefined:
 		break;
 
@@ -578,7 +729,14 @@ void ExpressoType::SetValue(UArticyBaseObject* Object, FString Property) const
 	auto setter = GetDefinition(type).Setter;
 
 	if (ensureMsgf(setter, TEXT("Property %s has unknown type %s!"), *Property, *type.ToString()))
+	{
+		// only read the old value if someone is recording
+		FArticyChangeJournal* journal = FArticyChangeJournal::GetActive();
+		if (journal)
+			journal->RecordProperty(Object, prop->GetFName(), GetDefinition(type).Factory(Object, prop), *this);
+
 		setter(Object, prop, *this);
+	}
 }
 
 UArticyBaseObject* ExpressoType::TryFeatureReroute(UArticyBaseObject* Object, FString& Property)
@@ -605,18 +763,6 @@ UArticyBaseObject* ExpressoType::TryFeatureReroute(UArticyBaseObject* Object, FS
 	return Object;
 }
 
-bool& ExpressoType::GetBool() { return BoolValue; }
-const bool& ExpressoType::GetBool() const { return BoolValue; }
-
-int64& ExpressoType::GetInt() { return IntValue; }
-const int64& ExpressoType::GetInt() const { return IntValue; }
-
-double& ExpressoType::GetFloat() { return FloatValue; }
-const double& ExpressoType::GetFloat() const { return FloatValue; }
-
-FString& ExpressoType::GetString() { return StringValue; }
-const FString& ExpressoType::GetString() const { return StringValue; }
-
 ExpressoType::ExpressoType(const int32& Value) : ExpressoType(int64(Value)) {}
 ExpressoType::ExpressoType(const int16& Value) : ExpressoType(int64(Value)) {}
 ExpressoType::ExpressoType(const int8& Value) : ExpressoType(int64(Value)) {}
@@ -626,7 +772,7 @@ ExpressoType::ExpressoType(const uint16& Value) : ExpressoType(int64(Value)) {}
 ExpressoType::ExpressoType(const uint8& Value) : ExpressoType(int64(Value)) {}
 ExpressoType::ExpressoType(const float& Value) : ExpressoType(double(Value)) {}
 ExpressoType::ExpressoType(const FText& Value) : ExpressoType(Value.ToString()) {}
-ExpressoType::ExpressoType(const FName& Value) : ExpressoType(Value.ToString()) {}
+ExpressoType::ExpressoType(const FName& Value) { SetString(InternName(Value)); }
 
 ExpressoType::operator int8() const { return int64(*this); }
 ExpressoType::operator uint8() const { return int64(*this); }
@@ -638,7 +784,7 @@ ExpressoType::operator uint64() const { return int64(*this); }
 ExpressoType::operator float() const { return double(*this); }
 ExpressoType::operator FText() const { return FText::FromString(FString(*this)); }
 ExpressoType::operator FName() const { return *FString(*this); }
-ExpressoType::operator FArticyId() const { return int64(*this); }
+ExpressoType::operator FArticyId() const { return Type == ObjectRef ? FArticyId{ ObjectId } : FArticyId{ static_cast<uint64>(int64(*this)) }; }
 
 bool ExpressoType::operator<=(const ExpressoType& Other) const { return !(*this > Other); }
 bool ExpressoType::operator>=(const ExpressoType& Other) const { return !(*this < Other); }
@@ -660,12 +806,34 @@ bool UArticyExpressoScripts::Evaluate(const int& ConditionFragmentHash, UArticyG
 	return result;
 }
 
+void UArticyExpressoScripts::EvaluateBatch(TArrayView<const int32> ConditionFragmentHashes, UArticyGlobalVariables* GV,
+                                           UObject* MethodProvider, TArrayView<bool> OutResults) const
+{
+	check(ConditionFragmentHashes.Num() == OutResults.Num());
+
+	SetGV(GV);
+	UserMethodsProvider = MethodProvider;
+
+	for (int32 i = 0; i < ConditionFragmentHashes.Num(); ++i)
+	{
+		auto condition = Conditions.Find(ConditionFragmentHashes[i]);
+		OutResults[i] = ensure(condition) && (*condition)();
+	}
+
+	// Clear methods provider
+	UserMethodsProvider = nullptr;
+	SetGV(nullptr);
+}
+
 bool UArticyExpressoScripts::Execute(const int& InstructionFragmentHash, UArticyGlobalVariables* GV,
                                      UObject* MethodProvider) const
 {
 	SetGV(GV);
 	UserMethodsProvider = MethodProvider;
 
+	// give the recorded changes their script context
+	FArticyJournalScope journalScope(GV ? GV->GetChangeJournal() : nullptr, InstructionFragmentHash, self, speaker);
+
 	bool result = false;
 	auto instruction = Instructions.Find(InstructionFragmentHash);
 	if (ensure(instruction))
@@ -690,11 +858,25 @@ UArticyObject* UArticyExpressoScripts::getObj(const FString& NameOrId, const uin
 	return OwningDatabase->GetObjectByName(*NameOrId, CloneId);
 }
 
+UArticyObject* UArticyExpressoScripts::getObj(const FArticyObjectHandle& Handle) const
+{
+	return OwningDatabase->GetObject(Handle);
+}
+
 UArticyObject* UArticyExpressoScripts::getObjInternal(const ExpressoType& Id_CloneId) const
 {
-	//only works for strings!
+	//object references are resolved without any parsing
+	if (Id_CloneId.Type == ExpressoType::ObjectRef)
+	{
+		if (Id_CloneId.ObjectId == 0)
+			return nullptr;
+
+		return OwningDatabase->GetObject<UArticyObject>(FArticyId{ Id_CloneId.ObjectId }, Id_CloneId.CloneId);
+	}
+
+	//otherwise only works for strings of the format ARTICYID_CLONEID
 	if (!ensureMsgf(Id_CloneId.Type == ExpressoType::String,
-	                TEXT("getObj(Id_CloneId) only works for string-ExpressoType!")))
+	                TEXT("getObj(Id_CloneId) only works for object references or string-ExpressoType!")))
 		return nullptr;
 
 	//parse id and cloneId from the compound id
@@ -726,11 +908,67 @@ UObject* UArticyExpressoScripts::GetUserMethodsProviderObject() const
 	return nullptr;
 }
 
+void* UArticyExpressoScripts::GetNativeUserMethodsProvider(UObject* MethodProvider, bool bSkipBlueprints) const
+{
+	if (!MethodProvider)
+		return nullptr;
+
+	if (BoundMethodsProvider.Get() != MethodProvider)
+	{
+		// GetUserMethodsProviderInterface is overridden by the generated class, and doesn't change anything
+		auto userMethodsInterface = const_cast<UArticyExpressoScripts*>(this)->GetUserMethodsProviderInterface();
+
+		BoundMethodsProvider = MethodProvider;
+		BoundMethodsProviderInterface = userMethodsInterface ? MethodProvider->GetNativeInterfaceAddress(userMethodsInterface) : nullptr;
+		bBoundMethodsProviderIsBlueprint = MethodProvider->GetClass()->HasAnyClassFlags(CLASS_CompiledFromBlueprint);
+	}
+
+	if (bSkipBlueprints && bBoundMethodsProviderIsBlueprint)
+		return nullptr;
+
+	return BoundMethodsProviderInterface;
+}
+
 void UArticyExpressoScripts::PrintInternal(const FString& msg)
 {
 	UE_LOG(LogArticyRuntime, Log, TEXT("%s"), *msg);
 }
 
+FString UArticyExpressoScripts::FormatMessage(const FString& Msg, const TArray<ExpressoType>& Args)
+{
+	if (Args.Num() == 0)
+		return Msg;
+
+	FString msg;
+	msg.Reserve(Msg.Len());
+
+	const TCHAR* chars = *Msg;
+	const int32 length = Msg.Len();
+	int32 literalStart = 0;
+	for (int32 i = 0; i < length; ++i)
+	{
+		if (chars[i] != TEXT('{') || i + 2 >= length || !FChar::IsDigit(chars[i + 1]))
+			continue;
+
+		int32 end = i + 1;
+		int32 index = 0;
+		while (end < length && FChar::IsDigit(chars[end]))
+			index = index * 10 + (chars[end++] - TEXT('0'));
+
+		// placeholders without a matching argument are kept, like the text around them
+		if (end >= length || chars[end] != TEXT('}') || !Args.IsValidIndex(index))
+			continue;
+
+		msg.AppendChars(chars + literalStart, i - literalStart);
+		msg += FString{ Args[index] };
+		literalStart = end + 1;
+		i = end;
+	}
+
+	msg.AppendChars(chars + literalStart, length - literalStart);
+	return msg;
+}
+
 void UArticyExpressoScripts::setProp(UArticyBaseObject* Object, const FString& Property, const ExpressoType& Value)
 {
 	Value.SetValue(Object, Property);
@@ -739,6 +977,13 @@ void UArticyExpressoScripts::setProp(UArticyBaseObject* Object, const FString& P
 void UArticyExpressoScripts::setProp(const ExpressoType& Id_CloneId, const FString& Property,
                                      const ExpressoType& Value) const
 {
+	//delta clones only store the value, everything else is set on the object directly
+	if (Id_CloneId.Type == ExpressoType::ObjectRef && OwningDatabase->IsDeltaClone(FArticyId{ Id_CloneId.ObjectId }, Id_CloneId.CloneId))
+	{
+		OwningDatabase->SetCloneProperty(FArticyId{ Id_CloneId.ObjectId }, Id_CloneId.CloneId, *Property, Value);
+		return;
+	}
+
 	setProp(getObjInternal(Id_CloneId), Property, Value);
 }
 
@@ -749,6 +994,14 @@ ExpressoType UArticyExpressoScripts::getProp(UArticyBaseObject* Object, const FS
 
 ExpressoType UArticyExpressoScripts::getProp(const ExpressoType& Id_CloneId, const FString& Property) const
 {
+	//delta clones are read without materializing them, everything else is read from the object directly
+	if (Id_CloneId.Type == ExpressoType::ObjectRef && OwningDatabase->IsDeltaClone(FArticyId{ Id_CloneId.ObjectId }, Id_CloneId.CloneId))
+	{
+		ExpressoType value;
+		OwningDatabase->GetCloneProperty(FArticyId{ Id_CloneId.ObjectId }, Id_CloneId.CloneId, *Property, value);
+		return value;
+	}
+
 	return getProp(getObjInternal(Id_CloneId), Property);
 }
 
@@ -792,7 +1045,7 @@ ExpressoType UArticyExpressoScripts::random(const ExpressoType& Min, const Expre
 		return FMath::RandRange((float)Min.GetFloat(), (float)Max.GetFloat());
 	}
 
-	if(Min.Type == Min.Bool || Min.Type== Min.String || Min.Type == Min.Undefined)
+	if(Min.Type == Min.Bool || Min.Type== Min.String || Min.Type == Min.ObjectRef || Min.Type == Min.Undefined)
 	{
 		ensureMsgf(false, TEXT("Cannot evaluate random value from %s"), *Min.ToString());
 	}
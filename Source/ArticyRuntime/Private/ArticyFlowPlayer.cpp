@@ -12,6 +12,8 @@
 #include "Interfaces/ArticyInputPinsProvider.h"
 #include "Interfaces/ArticyOutputPinsProvider.h"
 #include "Engine/Texture2D.h"
+#include "Engine/AssetManager.h"
+#include "ArticyAsset.h"
 
 
 TScriptInterface<IArticyFlowObject> FArticyBranch::GetTarget() const
@@ -33,6 +35,13 @@ void UArticyFlowPlayer::BeginPlay()
 	}
 }
 
+void UArticyFlowPlayer::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CancelPrefetchedAssets();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 //---------------------------------------------------------------------------//
 
 void UArticyFlowPlayer::SetStartNode(FArticyRef StartNodeId)
@@ -137,52 +146,155 @@ UArticyGlobalVariables* UArticyFlowPlayer::GetGVs() const
 
 UObject* UArticyFlowPlayer::GetMethodsProvider() const
 {
-	auto expressoInstance = GetDB()->GetExpressoInstance();
-	auto provider = expressoInstance->GetUserMethodsProviderInterface();
+	//during an exploration, all nodes use the provider resolved when it started
+	if(ActiveMethodsProvider)
+		return ActiveMethodsProvider;
+
+	auto expressoInstance = ResolvedExpressoInstance.Get();
+	if(!expressoInstance)
+	{
+		auto db = GetDB();
+		expressoInstance = db ? db->GetExpressoInstance() : nullptr;
+		if(!ensure(expressoInstance))
+			return UserMethodsProvider;
+
+		ResolvedExpressoInstance = expressoInstance;
+		bMethodsProviderResolved = false;
+	}
 
-	if(ensure(provider))
+	//search again if the set provider, the default provider or the components of the owner changed
+	const AActor* actor = GetOwner();
+	const int32 numComponents = actor ? actor->GetComponents().Num() : 0;
+	UObject* defaultUserMethodsProvider = expressoInstance->GetDefaultUserMethodsProvider();
+
+	//a component found as provider must still be a registered component of the owner
+	const auto providerComponent = Cast<UActorComponent>(ResolvedMethodsProvider.Get());
+	const bool bComponentRemoved = providerComponent && providerComponent != this
+		&& (providerComponent->GetOwner() != actor || !providerComponent->IsRegistered());
+
+	if(!bMethodsProviderResolved
+		|| ResolvedForUserMethodsProvider.Get() != UserMethodsProvider
+		|| ResolvedForDefaultMethodsProvider.Get() != defaultUserMethodsProvider
+		|| ResolvedForNumComponents != numComponents
+		|| bComponentRemoved
+		|| ResolvedMethodsProvider.IsStale())
 	{
-		//check if the set provider implements the required interface
-		if(!UserMethodsProvider || !ensure(UserMethodsProvider->GetClass()->ImplementsInterface(provider)))
+		ResolvedMethodsProvider = FindMethodsProvider(expressoInstance);
+		ResolvedForUserMethodsProvider = UserMethodsProvider;
+		ResolvedForDefaultMethodsProvider = defaultUserMethodsProvider;
+		ResolvedForNumComponents = numComponents;
+		bMethodsProviderResolved = true;
+	}
+
+	return ResolvedMethodsProvider.Get();
+}
+
+void UArticyFlowPlayer::SetUserMethodsProvider(UObject* MethodsProvider)
+{
+	UserMethodsProvider = MethodsProvider;
+	bMethodsProviderResolved = false;
+}
+
+UObject* UArticyFlowPlayer::FindMethodsProvider(UArticyExpressoScripts* ExpressoInstance) const
+{
+	auto provider = ExpressoInstance->GetUserMethodsProviderInterface();
+	if(!ensure(provider))
+		return UserMethodsProvider;
+
+	//check if the set provider implements the required interface
+	if(UserMethodsProvider && ensure(UserMethodsProvider->GetClass()->ImplementsInterface(provider)))
+		return UserMethodsProvider;
+
+	//no valid UserMethodsProvider set, search for it
+
+	//check if the flow player itself implements it
+	if(GetClass()->ImplementsInterface(provider))
+		return const_cast<UArticyFlowPlayer*>(this);
+
+	auto actor = GetOwner();
+	if(ensure(actor))
+	{
+		//check if the flow player's owning actor implements it
+		if(actor->GetClass()->ImplementsInterface(provider))
+			return actor;
+
+		//check if any other component implements it
+		for(auto comp : actor->GetComponents())
 		{
+			if(comp && comp->GetClass()->ImplementsInterface(provider))
+				return comp;
+		}
+	}
 
-			//no valid UserMethodsProvider set, search for it
+	//and finally we check for a default methods provider, which we can use as fallback
+	auto defaultUserMethodsProvider = ExpressoInstance->GetDefaultUserMethodsProvider();
+	if(defaultUserMethodsProvider && ensure(defaultUserMethodsProvider->GetClass()->ImplementsInterface(provider)))
+		return defaultUserMethodsProvider;
 
-			//check if the flow player itself implements it
-			if(GetClass()->ImplementsInterface(provider))
-				UserMethodsProvider = const_cast<UArticyFlowPlayer*>(this);
-			else
-			{
-				auto actor = GetOwner();
-				if(ensure(actor))
-				{
-					//check if the flow player's owning actor implements it
-					if(actor->GetClass()->ImplementsInterface(provider))
-						UserMethodsProvider = actor;
-					else
-					{
-						//check if any other component implements it
-						auto components = actor->GetComponents();
-						for(auto comp : components)
-						{
-							if(comp->GetClass()->ImplementsInterface(provider))
-							{
-								UserMethodsProvider = comp;
-								break;
-							}
-						}
-
-						//and finally we check for a default methods provider, which we can use as fallback
-						auto defaultUserMethodsProvider = expressoInstance->GetDefaultUserMethodsProvider();
-						if(defaultUserMethodsProvider && ensure(defaultUserMethodsProvider->GetClass()->ImplementsInterface(provider)))
-							UserMethodsProvider = defaultUserMethodsProvider;
-					}
-				}
-			}
+	return nullptr;
+}
+
+void UArticyFlowPlayer::UpdatePrefetchedAssets()
+{
+	const auto db = GetDB();
+	if (!db || !UAssetManager::IsValid())
+		return;
+
+	// the cursor first, then the branches step by step, so the nodes closest to the cursor come first
+	TArray<UArticyAsset*> assets;
+	UArticyAsset::GetReferencedAssets(db, Cursor.GetObject(), assets);
+
+	int32 maxPathLength = 0;
+	for (const auto& branch : AvailableBranches)
+		maxPathLength = FMath::Max(maxPathLength, branch.Path.Num());
+
+	for (int32 step = 0; step < maxPathLength && assets.Num() < MaxPrefetchedAssets; ++step)
+	{
+		for (const auto& branch : AvailableBranches)
+		{
+			if (branch.Path.IsValidIndex(step) && (branch.bIsValid || !bIgnoreInvalidBranches))
+				UArticyAsset::GetReferencedAssets(db, branch.Path[step].GetObject(), assets);
+		}
+	}
+
+	if (assets.Num() > MaxPrefetchedAssets)
+		assets.SetNum(MaxPrefetchedAssets);
+
+	auto& streamableManager = UAssetManager::GetStreamableManager();
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> handles;
+	for (int32 i = 0; i < assets.Num(); ++i)
+	{
+		const auto& path = assets[i]->GetAssetPath();
+		if (path.IsNull() || handles.Contains(path))
+			continue;
+
+		TSharedPtr<FStreamableHandle> handle;
+		if (!PrefetchHandles.RemoveAndCopyValue(path, handle))
+		{
+			// earlier assets are needed sooner
+			const TAsyncLoadPriority priority = FStreamableManager::DefaultAsyncLoadPriority + assets.Num() - i;
+			handle = streamableManager.RequestAsyncLoad(path, FStreamableDelegate(), priority);
 		}
+
+		if (handle.IsValid())
+			handles.Add(path, handle);
 	}
 
-	return UserMethodsProvider;
+	// whatever is left belongs to branches which were not taken
+	CancelPrefetchedAssets();
+	PrefetchHandles = MoveTemp(handles);
+}
+
+void UArticyFlowPlayer::CancelPrefetchedAssets()
+{
+	for (const auto& entry : PrefetchHandles)
+	{
+		if (entry.Value->IsLoadingInProgress())
+			entry.Value->CancelHandle();
+		else
+			entry.Value->ReleaseHandle();
+	}
+	PrefetchHandles.Reset();
 }
 
 IArticyFlowObject* UArticyFlowPlayer::GetUnshadowedNode(IArticyFlowObject* Node)
@@ -354,7 +466,11 @@ void UArticyFlowPlayer::UpdateAvailableBranchesInternal(bool Startup)
 	else
 	{
 		const bool bMustBeShadowed = true;
-		AvailableBranches = Explore(&*Cursor, bMustBeShadowed, 0, Startup);
+		{
+			//the methods provider is resolved once for all explored nodes
+			TGuardValue<UObject*> methodsProviderGuard(ActiveMethodsProvider, GetMethodsProvider());
+			AvailableBranches = Explore(&*Cursor, bMustBeShadowed, 0, Startup);
+		}
 
 		// Prune empty branches
 		AvailableBranches.RemoveAllSwap([](const FArticyBranch& branch) { return branch.Path.Num() == 0; });
@@ -370,6 +486,9 @@ void UArticyFlowPlayer::UpdateAvailableBranchesInternal(bool Startup)
 			return;
 		}
 
+		if (bPrefetchBranchAssets)
+			UpdatePrefetchedAssets();
+
 		//broadcast and return result
 		OnPlayerPaused.Broadcast(Cursor);
 		OnBranchesUpdated.Broadcast(AvailableBranches);
@@ -392,8 +511,10 @@ bool UArticyFlowPlayer::OnTick(float DeltaTime)
 				return true;
 		}
 
+		auto gvs = GetGVs();
+		auto methodsProvider = GetMethodsProvider();
 		for (auto node : Branch.Path)
-			node->Execute(GetGVs(), GetMethodsProvider());
+			node->Execute(gvs, methodsProvider);
 
 		Cursor = Branch.Path.Last();
 		UpdateAvailableBranches();
@@ -496,8 +617,12 @@ void UArticyFlowPlayer::PlayBranch(const FArticyBranch& Branch)
 		return;
 	}
 
+	BranchPlayedEvent.Broadcast(this, Branch);
+
+	auto gvs = GetGVs();
+	auto methodsProvider = GetMethodsProvider();
 	for(auto node : Branch.Path)
-		node->Execute(GetGVs(), GetMethodsProvider());
+		node->Execute(gvs, methodsProvider);
 
 	Cursor = Branch.Path.Last();
 	UpdateAvailableBranches();
@@ -7,6 +7,7 @@
 #include "ArticyFunctionLibrary.h"
 #include "ArticyObject.h"
 #include "ArticyFlowPlayer.h"
+#include "ArticyDatabase.h"
 
 UArticyObject* UArticyFunctionLibrary::ArticyRef_GetObject(FArticyRef Ref, TSubclassOf<class UArticyObject> CastTo, const UObject* WorldContext)
 {
@@ -78,6 +79,11 @@ FArticyGvName UArticyFunctionLibrary::ArticyGvName_MakeFromVariableAndNamespace(
 	return FArticyGvName(Variable, Namespace);
 }
 
+TArray<UArticyObject*> UArticyFunctionLibrary::RunArticyQuery(const FArticyQuery& Query, const UObject* WorldContext)
+{
+	return Query.Execute(UArticyDatabase::Get(WorldContext));
+}
+
 TScriptInterface<IArticyFlowObject> UArticyFunctionLibrary::GetBranchTarget(const FArticyBranch& Branch)
 {
 	return Branch.GetTarget();
@@ -11,6 +11,7 @@
 #include "ArticyPluginSettings.h"
 #include "ArticyFlowPlayer.h"
 #include "ArticyAlternativeGlobalVariables.h"
+#include "ArticySubsystem.h"
 #include "AssetRegistry/AssetData.h"
 
 
@@ -75,9 +76,40 @@ const FName& FArticyGvName::GetFullName()
 
 //---------------------------------------------------------------------------//
 
-uint32 UArticyVariable::GetStoreShadowLevel() const
+void UArticyVariable::NotifyStoreOfChange()
 {
-	return Store->GetShadowLevel();
+	if(Store)
+		Store->OnAnyVariableChanged().Broadcast(this);
+}
+
+int32& UArticyEnum::operator=(const FString& NewName)
+{
+	const int32 index = FindValue(FName(*NewName));
+	if (index == INDEX_NONE)
+	{
+		UE_LOG(LogArticyRuntime, Error, TEXT("'%s' is not a value of the enum variable %s."), *NewName, *GVName.ToString());
+		return Value;
+	}
+
+	return *this = index;
+}
+
+int32& UArticyEnum::operator=(const ExpressoType& NewValue)
+{
+	if (NewValue.Type == ExpressoType::String)
+		return *this = NewValue.GetString();
+
+	return FVariableAccess::operator=(NewValue);
+}
+
+bool UArticyEnum::SetByName(FName NewName)
+{
+	const int32 index = FindValue(NewName);
+	if (index == INDEX_NONE)
+		return false;
+
+	Set(index);
+	return true;
 }
 
 void UArticyBaseVariableSet::BroadcastOnVariableChanged(UArticyVariable* Variable)
@@ -89,6 +121,10 @@ void UArticyBaseVariableSet::BroadcastOnVariableChanged(UArticyVariable* Variabl
 
 UArticyGlobalVariables* UArticyGlobalVariables::GetDefault(const UObject* WorldContext)
 {
+	//in a game, the global variables are owned by the subsystem of the game instance
+	if(auto subsystem = UArticySubsystem::Get(WorldContext))
+		return subsystem->GetGlobalVariables(GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull));
+
 	if(!Clone.IsValid())
 	{
 		bool keepBetweenWorlds = UArticyPluginSettings::Get()->bKeepGlobalVariablesBetweenWorlds;
@@ -119,25 +155,35 @@ UArticyGlobalVariables* UArticyGlobalVariables::GetDefault(const UObject* WorldC
 		auto world = GEngine->GetWorldFromContextObjectChecked(WorldContext);
 		ensureMsgf(world, TEXT("Getting world for GV cloning failed!"));
 
-		const auto assetPtr = asset;
 		if(keepBetweenWorlds)
 		{
-			Clone = DuplicateObject<UArticyGlobalVariables>(assetPtr, Cast<UObject>(world->GetGameInstance()), TEXT("Persistent Runtime GV"));
+			Clone = CreateRuntimeInstance(world->GetGameInstance(), asset, TEXT("Persistent Runtime GV"));
 #if !WITH_EDITOR
-			Clone->AddToRoot();
+			if(Clone.IsValid())
+				Clone->AddToRoot();
 #endif
 		}
 		else
 		{
-			Clone = DuplicateObject<UArticyGlobalVariables>(assetPtr, Cast<UObject>(world), *FString::Printf(TEXT("%s GV"), *world->GetName()));
+			Clone = CreateRuntimeInstance(world, asset, *FString::Printf(TEXT("%s GV"), *world->GetName()));
 		}
-
-		ensureMsgf(Clone.IsValid(), TEXT("Cloning GV asset failed!"));
 	}
 
 	return Clone.Get();
 }
 
+UArticyGlobalVariables* UArticyGlobalVariables::CreateRuntimeInstance(UObject* Outer, UArticyGlobalVariables* Asset, const FName& Name)
+{
+	if(!Asset)
+		return nullptr;
+
+	auto clone = DuplicateObject<UArticyGlobalVariables>(Asset, Outer, Name);
+	if(ensureMsgf(clone, TEXT("Cloning GV asset failed!")))
+		clone->ApplyChangeJournalSettings();
+
+	return clone;
+}
+
 UArticyGlobalVariables* UArticyGlobalVariables::GetMutableOriginal()
 {
 	static TWeakObjectPtr<UArticyGlobalVariables> Asset = nullptr;
@@ -176,6 +222,10 @@ UArticyGlobalVariables* UArticyGlobalVariables::GetRuntimeClone(const UObject* W
 	// Special case: We're passed a nullptr. Use the default shared set.
 	if (GVs == nullptr) { return GetDefault(WorldContext);  }
 
+	// In a game, the clones are owned by the subsystem of the game instance
+	if (auto subsystem = UArticySubsystem::Get(WorldContext))
+		return subsystem->GetRuntimeGlobalVariables(GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull), GVs);
+
 	// Get unique name of GV set
 	const FString Name = GVs->GetFullName();
 	const FName Key = FName(*Name);
@@ -202,19 +252,19 @@ UArticyGlobalVariables* UArticyGlobalVariables::GetRuntimeClone(const UObject* W
 
 	// If so, duplicate and add to root
 	UArticyGlobalVariables* NewClone = nullptr;
-	const auto assetPtr = asset;
 	if (keepBetweenWorlds)
 	{
 		FString NewName = TEXT("Persistent Runtime GV Clone of ") + Name;
-		NewClone = DuplicateObject<UArticyGlobalVariables>(assetPtr, Cast<UObject>(world->GetGameInstance()), *NewName);
+		NewClone = CreateRuntimeInstance(world->GetGameInstance(), asset, *NewName);
 #if !WITH_EDITOR
-		NewClone->AddToRoot();
+		if (NewClone)
+			NewClone->AddToRoot();
 #endif
 	}
 	else
 	{
 		// Otherwise, add it to the active world
-		NewClone = DuplicateObject(assetPtr, Cast<UObject>(world), *FString::Printf(TEXT("%s %s GV"), *world->GetName(), *Name));
+		NewClone = CreateRuntimeInstance(world, asset, *FString::Printf(TEXT("%s %s GV"), *world->GetName(), *Name));
 	}
 
 	// Store and return
@@ -224,6 +274,15 @@ UArticyGlobalVariables* UArticyGlobalVariables::GetRuntimeClone(const UObject* W
 
 void UArticyGlobalVariables::UnloadGlobalVariables()
 {
+	if (auto subsystem = UArticySubsystem::Get(this))
+	{
+		if (subsystem->ReleaseGlobalVariables(this))
+		{
+			ConditionalBeginDestroy();
+			return;
+		}
+	}
+
 	if (Clone.IsValid())
 	{
 		Clone->RemoveFromRoot();
@@ -281,6 +340,18 @@ void UArticyGlobalVariables::PrintGlobalVariable(FArticyGvName GvName)
 			UE_LOG(LogArticyRuntime, Display, TEXT("%s::%s = %s"), *GvName.GetNamespace().ToString(), *GvName.GetVariable().ToString(), *stringValue);
 			bPrintSuccessful = true;
 		}
+		else if (Cast<UArticyFloat>(*basePtr))
+		{
+			bool floatSucceeded = false;
+			auto floatValue = GetFloatVariable(GvName, floatSucceeded);
+			UE_LOG(LogArticyRuntime, Display, TEXT("%s::%s = %f"), *GvName.GetNamespace().ToString(), *GvName.GetVariable().ToString(), floatValue);
+			bPrintSuccessful = true;
+		}
+		else if (auto enumVar = Cast<UArticyEnum>(*basePtr))
+		{
+			UE_LOG(LogArticyRuntime, Display, TEXT("%s::%s = %s (%d)"), *GvName.GetNamespace().ToString(), *GvName.GetVariable().ToString(), *enumVar->GetValueName().ToString(), enumVar->Get());
+			bPrintSuccessful = true;
+		}
 	}
 
 	if(!bPrintSuccessful)
@@ -307,6 +378,33 @@ const FString& UArticyGlobalVariables::GetStringVariable(FArticyGvName GvName, b
 	return GetVariableValue<UArticyString, FString>(GvName.GetNamespace(), GvName.GetVariable(), bSucceeded);
 }
 
+const float& UArticyGlobalVariables::GetFloatVariable(FArticyGvName GvName, bool& bSucceeded)
+{
+	return GetVariableValue<UArticyFloat, float>(GvName.GetNamespace(), GvName.GetVariable(), bSucceeded);
+}
+
+FName UArticyGlobalVariables::GetEnumVariable(FArticyGvName GvName, bool& bSucceeded)
+{
+	auto set = GetNamespace(GvName.GetNamespace());
+	UArticyVariable** basePtr = set ? set->GetPropPtr<UArticyVariable*>(GvName.GetVariable()) : nullptr;
+	const UArticyEnum* enumVar = basePtr ? Cast<UArticyEnum>(*basePtr) : nullptr;
+
+	bSucceeded = enumVar != nullptr;
+	if (bLogVariableAccess)
+	{
+		if (bSucceeded)
+		{
+			UE_LOG(LogArticyRuntime, Display, TEXT("Get variable %s::%s : Success"), *GvName.GetNamespace().ToString(), *GvName.GetVariable().ToString());
+		}
+		else
+		{
+			UE_LOG(LogArticyRuntime, Error, TEXT("Unable to find variable: %s::%s"), *GvName.GetNamespace().ToString(), *GvName.GetVariable().ToString());
+		}
+	}
+
+	return enumVar ? enumVar->GetValueName() : NAME_None;
+}
+
 void UArticyGlobalVariables::SetBoolVariable(FArticyGvName GvName, const bool Value)
 {
 	SetVariableValue<UArticyBool>(GvName.GetNamespace(), GvName.GetVariable(), Value);
@@ -322,6 +420,16 @@ void UArticyGlobalVariables::SetStringVariable(FArticyGvName GvName, const FStri
 	SetVariableValue<UArticyString>(GvName.GetNamespace(), GvName.GetVariable(), Value);
 }
 
+void UArticyGlobalVariables::SetFloatVariable(FArticyGvName GvName, const float Value)
+{
+	SetVariableValue<UArticyFloat>(GvName.GetNamespace(), GvName.GetVariable(), Value);
+}
+
+void UArticyGlobalVariables::SetEnumVariable(FArticyGvName GvName, const FName Value)
+{
+	SetVariableValue<UArticyEnum>(GvName.GetNamespace(), GvName.GetVariable(), Value.ToString());
+}
+
 void UArticyGlobalVariables::EnableDebugLogging()
 {
 	bLogVariableAccess = true;
@@ -335,3 +443,35 @@ void UArticyGlobalVariables::DisableDebugLogging()
 TWeakObjectPtr<UArticyGlobalVariables> UArticyGlobalVariables::Clone;
 TMap<FName, TWeakObjectPtr< UArticyGlobalVariables>> UArticyGlobalVariables::OtherClones;
 
+void UArticyGlobalVariables::EnableChangeJournal(int32 Capacity)
+{
+	if(ChangeJournal.IsValid() && ChangeJournal->GetCapacity() == Capacity)
+		return;
+
+	ChangeJournal = MakeShared<FArticyChangeJournal>(Capacity);
+}
+
+void UArticyGlobalVariables::DisableChangeJournal()
+{
+	ChangeJournal.Reset();
+}
+
+int32 UArticyGlobalVariables::RewindChangeJournal(int32 Sequence)
+{
+	if(!ChangeJournal.IsValid())
+	{
+		UE_LOG(LogArticyRuntime, Warning, TEXT("Cannot rewind %s, the change journal is not enabled."), *GetName());
+		return 0;
+	}
+
+	return ChangeJournal->RewindTo(static_cast<uint32>(FMath::Max(0, Sequence)));
+}
+
+void UArticyGlobalVariables::ApplyChangeJournalSettings()
+{
+#if !UE_BUILD_SHIPPING
+	const auto settings = UArticyPluginSettings::Get();
+	if(settings->bRecordChangeJournal)
+		EnableChangeJournal(settings->ChangeJournalCapacity);
+#endif
+}
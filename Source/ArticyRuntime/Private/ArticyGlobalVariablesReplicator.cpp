@@ -0,0 +1,259 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "ArticyGlobalVariablesReplicator.h"
+#include "ArticyGlobalVariables.h"
+#include "ArticyAlternativeGlobalVariables.h"
+#include "ArticyRuntimeModule.h"
+#include "Net/UnrealNetwork.h"
+
+bool FArticyReplicatedVariable::CaptureValue(const UArticyVariable* Variable)
+{
+	if (auto boolVar = Cast<UArticyBool>(Variable))
+	{
+		const int32 newValue = boolVar->Get() ? 1 : 0;
+		const bool bChanged = Type != EArticyReplicatedVariableType::Bool || IntValue != newValue;
+		Type = EArticyReplicatedVariableType::Bool;
+		IntValue = newValue;
+		return bChanged;
+	}
+	if (auto intVar = Cast<UArticyInt>(Variable))
+	{
+		const int32 newValue = intVar->Get();
+		const bool bChanged = Type != EArticyReplicatedVariableType::Int || IntValue != newValue;
+		Type = EArticyReplicatedVariableType::Int;
+		IntValue = newValue;
+		return bChanged;
+	}
+	if (auto stringVar = Cast<UArticyString>(Variable))
+	{
+		const FString& newValue = stringVar->Get();
+		const bool bChanged = Type != EArticyReplicatedVariableType::String || !StringValue.Equals(newValue, ESearchCase::CaseSensitive);
+		Type = EArticyReplicatedVariableType::String;
+		StringValue = newValue;
+		return bChanged;
+	}
+	if (auto floatVar = Cast<UArticyFloat>(Variable))
+	{
+		const float newValue = floatVar->Get();
+		const bool bChanged = Type != EArticyReplicatedVariableType::Float || FloatValue != newValue;
+		Type = EArticyReplicatedVariableType::Float;
+		FloatValue = newValue;
+		return bChanged;
+	}
+	if (auto enumVar = Cast<UArticyEnum>(Variable))
+	{
+		const int32 newValue = enumVar->Get();
+		const bool bChanged = Type != EArticyReplicatedVariableType::Enum || IntValue != newValue;
+		Type = EArticyReplicatedVariableType::Enum;
+		IntValue = newValue;
+		return bChanged;
+	}
+
+	return false;
+}
+
+void FArticyReplicatedVariable::ApplyValue(UArticyVariable* Variable) const
+{
+	switch (Type)
+	{
+	case EArticyReplicatedVariableType::Bool:
+		if (auto boolVar = Cast<UArticyBool>(Variable))
+			boolVar->Set(IntValue != 0);
+		break;
+	case EArticyReplicatedVariableType::Int:
+		if (auto intVar = Cast<UArticyInt>(Variable))
+			intVar->Set(IntValue);
+		break;
+	case EArticyReplicatedVariableType::String:
+		if (auto stringVar = Cast<UArticyString>(Variable))
+			stringVar->Set(StringValue);
+		break;
+	case EArticyReplicatedVariableType::Float:
+		if (auto floatVar = Cast<UArticyFloat>(Variable))
+			floatVar->Set(FloatValue);
+		break;
+	case EArticyReplicatedVariableType::Enum:
+		if (auto enumVar = Cast<UArticyEnum>(Variable))
+			enumVar->Set(IntValue);
+		break;
+	}
+}
+
+void FArticyReplicatedVariable::PostReplicatedAdd(const FArticyReplicatedVariableArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+		InArraySerializer.Owner->OnSlotReceived(*this);
+}
+
+void FArticyReplicatedVariable::PostReplicatedChange(const FArticyReplicatedVariableArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+		InArraySerializer.Owner->OnSlotReceived(*this);
+}
+
+//---------------------------------------------------------------------------//
+
+UArticyGlobalVariablesReplicator::UArticyGlobalVariablesReplicator()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	ReplicatedVariables.Owner = this;
+
+#if ENGINE_MAJOR_VERSION >= 5 || (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 24)
+	SetIsReplicatedByDefault(true);
+#else
+	bReplicates = true;
+#endif
+}
+
+void UArticyGlobalVariablesReplicator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ReplicatedVariables.Owner = this;
+
+	if (GetOwnerRole() == ROLE_Authority)
+		RebuildSlots();
+}
+
+void UArticyGlobalVariablesReplicator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ClearSlots();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UArticyGlobalVariablesReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UArticyGlobalVariablesReplicator, ReplicatedVariables);
+}
+
+UArticyGlobalVariables* UArticyGlobalVariablesReplicator::GetGVs() const
+{
+	if (OverrideGV)
+		return UArticyGlobalVariables::GetRuntimeClone(this, OverrideGV);
+
+	return UArticyGlobalVariables::GetDefault(this);
+}
+
+void UArticyGlobalVariablesReplicator::SetNamespaceReplicated(FName Namespace, bool bReplicated)
+{
+	if (GetOwnerRole() != ROLE_Authority)
+		return;
+
+	// an empty ReplicatedNamespaces list means "everything", so a namespace is never removed from it, but excluded
+	if (bReplicated)
+	{
+		ExcludedNamespaces.Remove(Namespace);
+		if (ReplicatedNamespaces.Num() > 0)
+			ReplicatedNamespaces.AddUnique(Namespace);
+	}
+	else
+		ExcludedNamespaces.AddUnique(Namespace);
+
+	if (HasBegunPlay())
+		RebuildSlots();
+}
+
+bool UArticyGlobalVariablesReplicator::IsNamespaceReplicated(FName Namespace) const
+{
+	if (ExcludedNamespaces.Contains(Namespace))
+		return false;
+
+	return ReplicatedNamespaces.Num() == 0 || ReplicatedNamespaces.Contains(Namespace);
+}
+
+void UArticyGlobalVariablesReplicator::RebuildSlots()
+{
+	ClearSlots();
+
+	auto GVs = GetGVs();
+	if (!ensureMsgf(GVs, TEXT("ArticyGlobalVariablesReplicator: No global variables found to replicate.")))
+		return;
+
+	BoundGVs = GVs;
+
+	const auto& sets = GVs->GetVariableSets();
+	ensureMsgf(sets.Num() <= MAX_uint16, TEXT("ArticyGlobalVariablesReplicator: Too many namespaces to replicate."));
+
+	for (int32 setIndex = 0; setIndex < sets.Num() && setIndex <= MAX_uint16; ++setIndex)
+	{
+		const auto set = sets[setIndex];
+		if (!set || !IsNamespaceReplicated(set->GetFName()))
+			continue;
+
+		const auto& vars = set->Variables;
+		for (int32 varIndex = 0; varIndex < vars.Num() && varIndex <= MAX_uint16; ++varIndex)
+		{
+			const auto var = vars[varIndex];
+			if (!var)
+				continue;
+
+			FArticyReplicatedVariable slot;
+			slot.NamespaceIndex = static_cast<uint16>(setIndex);
+			slot.VariableIndex = static_cast<uint16>(varIndex);
+			slot.CaptureValue(var);
+
+			const int32 slotIndex = ReplicatedVariables.Items.Add(slot);
+			ReplicatedVariables.MarkItemDirty(ReplicatedVariables.Items[slotIndex]);
+
+			SlotByVariable.Add(var, slotIndex);
+			var->OnVariableChanged.AddDynamic(this, &UArticyGlobalVariablesReplicator::OnVariableChanged);
+		}
+	}
+}
+
+void UArticyGlobalVariablesReplicator::ClearSlots()
+{
+	for (auto& pair : SlotByVariable)
+	{
+		if (pair.Key.IsValid())
+			pair.Key->OnVariableChanged.RemoveDynamic(this, &UArticyGlobalVariablesReplicator::OnVariableChanged);
+	}
+
+	SlotByVariable.Reset();
+	BoundGVs.Reset();
+
+	if (ReplicatedVariables.Items.Num() > 0)
+	{
+		ReplicatedVariables.Items.Reset();
+		ReplicatedVariables.MarkArrayDirty();
+	}
+}
+
+void UArticyGlobalVariablesReplicator::OnSlotReceived(const FArticyReplicatedVariable& Slot)
+{
+	auto GVs = GetGVs();
+	if (!GVs)
+		return;
+
+	const auto& sets = GVs->GetVariableSets();
+	if (!sets.IsValidIndex(Slot.NamespaceIndex) || !sets[Slot.NamespaceIndex])
+	{
+		UE_LOG(LogArticyRuntime, Warning, TEXT("ArticyGlobalVariablesReplicator: Received invalid namespace index %d. Are server and client using the same articy export?"), Slot.NamespaceIndex);
+		return;
+	}
+
+	const auto& vars = sets[Slot.NamespaceIndex]->Variables;
+	if (!vars.IsValidIndex(Slot.VariableIndex) || !vars[Slot.VariableIndex])
+	{
+		UE_LOG(LogArticyRuntime, Warning, TEXT("ArticyGlobalVariablesReplicator: Received invalid variable index %d in namespace %s."), Slot.VariableIndex, *sets[Slot.NamespaceIndex]->GetName());
+		return;
+	}
+
+	Slot.ApplyValue(vars[Slot.VariableIndex]);
+}
+
+void UArticyGlobalVariablesReplicator::OnVariableChanged(UArticyVariable* Variable)
+{
+	const auto slotIndex = SlotByVariable.Find(Variable);
+	if (!slotIndex || !ReplicatedVariables.Items.IsValidIndex(*slotIndex))
+		return;
+
+	auto& slot = ReplicatedVariables.Items[*slotIndex];
+	if (slot.CaptureValue(Variable))
+		ReplicatedVariables.MarkItemDirty(slot);
+}
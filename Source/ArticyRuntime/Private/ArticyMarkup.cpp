@@ -0,0 +1,149 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "ArticyMarkup.h"
+
+namespace
+{
+	bool IsTagNameChar(const TCHAR Char)
+	{
+		return FChar::IsAlnum(Char) || Char == TEXT('_');
+	}
+}
+
+bool FArticyMarkupTokenizer::Next(FArticyMarkupToken& OutToken)
+{
+	if (bHasPendingTag)
+	{
+		OutToken = MoveTemp(PendingTag);
+		bHasPendingTag = false;
+		Position = OutToken.Start + OutToken.Length;
+		return true;
+	}
+
+	const int32 length = Source.Len();
+	if (Position >= length)
+		return false;
+
+	const TCHAR* chars = *Source;
+	for (int32 i = Position; i < length; ++i)
+	{
+		if (chars[i] != TEXT('<') || !ReadTag(i, PendingTag))
+			continue;
+
+		if (i == Position)
+		{
+			// the tag starts right here, no text in front of it
+			OutToken = MoveTemp(PendingTag);
+			Position = OutToken.Start + OutToken.Length;
+			return true;
+		}
+
+		bHasPendingTag = true;
+		OutToken = FArticyMarkupToken();
+		OutToken.Start = Position;
+		OutToken.Length = i - Position;
+		Position = i;
+		return true;
+	}
+
+	OutToken = FArticyMarkupToken();
+	OutToken.Start = Position;
+	OutToken.Length = length - Position;
+	Position = length;
+	return true;
+}
+
+bool FArticyMarkupTokenizer::ReadTag(const int32 Start, FArticyMarkupToken& OutToken) const
+{
+	const TCHAR* chars = *Source;
+	const int32 length = Source.Len();
+
+	int32 i = Start + 1;
+	if (i < length && chars[i] == TEXT('/'))
+	{
+		// a closing tag ends at the first '>' on the same line, and has at least one character
+		for (int32 end = i + 2; end < length && chars[end] != TEXT('\n'); ++end)
+		{
+			if (chars[end] == TEXT('>'))
+			{
+				OutToken = FArticyMarkupToken();
+				OutToken.Type = EArticyMarkupTokenType::CloseTag;
+				OutToken.Start = Start;
+				OutToken.Length = end + 1 - Start;
+				OutToken.Name = Source.Mid(i + 1, end - i - 1);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const int32 nameStart = i;
+	while (i < length && IsTagNameChar(chars[i]))
+		++i;
+	if (i == nameStart || i >= length)
+		return false;
+
+	const int32 nameEnd = i;
+	int32 valueStart = INDEX_NONE;
+	int32 valueEnd = INDEX_NONE;
+
+	if (chars[i] == TEXT('='))
+	{
+		++i;
+		if (i < length && chars[i] == TEXT('"'))
+			++i;
+
+		// the value has at least one character, and ends at the first '>' or '">'
+		valueStart = i;
+		for (int32 end = i + 1; end < length && chars[end] != TEXT('\n'); ++end)
+		{
+			if (chars[end] == TEXT('"') && end + 1 < length && chars[end + 1] == TEXT('>'))
+			{
+				valueEnd = end;
+				i = end + 1;
+				break;
+			}
+			if (chars[end] == TEXT('>'))
+			{
+				valueEnd = end;
+				i = end;
+				break;
+			}
+		}
+
+		if (valueEnd == INDEX_NONE)
+			return false;
+	}
+	else if (chars[i] != TEXT('>'))
+	{
+		return false;
+	}
+
+	OutToken = FArticyMarkupToken();
+	OutToken.Type = EArticyMarkupTokenType::OpenTag;
+	OutToken.Start = Start;
+	OutToken.Length = i + 1 - Start;
+	OutToken.Name = Source.Mid(nameStart, nameEnd - nameStart);
+	if (valueStart != INDEX_NONE)
+		OutToken.Value = Source.Mid(valueStart, valueEnd - valueStart);
+
+	return true;
+}
+
+bool ArticyMarkup::ParseLinkTarget(const FString& Link, FArticyId& OutId)
+{
+	static const FString Prefix = TEXT("articy://localhost/view/~/");
+
+	const int32 prefixIndex = Link.Find(Prefix, ESearchCase::CaseSensitive);
+	if (prefixIndex == INDEX_NONE)
+		return false;
+
+	const TCHAR* digits = *Link + prefixIndex + Prefix.Len();
+	if (!FChar::IsDigit(*digits))
+		return false;
+
+	OutId = FCString::Strtoui64(digits, nullptr, 10);
+	return true;
+}
@@ -0,0 +1,100 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "ArticyNameIndex.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
+
+namespace
+{
+	/** Levenshtein distance of A and B, or MaxDistance + 1 as soon as it is known to exceed MaxDistance. */
+	int32 GetBoundedEditDistance(const FString& A, const FString& B, const int32 MaxDistance)
+	{
+		const int32 lenA = A.Len();
+		const int32 lenB = B.Len();
+		if (FMath::Abs(lenA - lenB) > MaxDistance)
+			return MaxDistance + 1;
+
+		TArray<int32, TInlineAllocator<64>> previous, current;
+		previous.SetNumUninitialized(lenB + 1);
+		current.SetNumUninitialized(lenB + 1);
+		for (int32 j = 0; j <= lenB; ++j)
+			previous[j] = j;
+
+		for (int32 i = 1; i <= lenA; ++i)
+		{
+			current[0] = i;
+			int32 rowMin = i;
+			for (int32 j = 1; j <= lenB; ++j)
+			{
+				const int32 substitution = previous[j - 1] + (A[i - 1] == B[j - 1] ? 0 : 1);
+				current[j] = FMath::Min3(previous[j] + 1, current[j - 1] + 1, substitution);
+				rowMin = FMath::Min(rowMin, current[j]);
+			}
+
+			// every later row is at least as large as the minimum of this one
+			if (rowMin > MaxDistance)
+				return MaxDistance + 1;
+
+			Swap(previous, current);
+		}
+
+		return previous[lenB];
+	}
+}
+
+void FArticyNameIndex::Build(const TArray<FName>& Names)
+{
+	Entries.Reset(Names.Num());
+	for (const FName& name : Names)
+	{
+		if (!name.IsNone())
+			Entries.Add({ name.ToString().ToUpper(), name });
+	}
+
+	Entries.Sort([](const FEntry& A, const FEntry& B) { return A.Key < B.Key; });
+
+	// names only differing in case share an entry, like they share an FName
+	int32 num = 0;
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		if (num == 0 || !Entries[i].Key.Equals(Entries[num - 1].Key, ESearchCase::CaseSensitive))
+			Entries[num++] = MoveTemp(Entries[i]);
+	}
+	Entries.SetNum(num);
+}
+
+void FArticyNameIndex::FindWithPrefix(const FString& Prefix, TArray<FName>& OutNames, const int32 MaxResults) const
+{
+	const FString key = Prefix.ToUpper();
+	int32 index = Algo::LowerBoundBy(Entries, key, [](const FEntry& Entry) -> const FString& { return Entry.Key; });
+
+	for (int32 found = 0; index < Entries.Num() && (MaxResults <= 0 || found < MaxResults); ++index, ++found)
+	{
+		if (!Entries[index].Key.StartsWith(key, ESearchCase::CaseSensitive))
+			break;
+
+		OutNames.Add(Entries[index].Name);
+	}
+}
+
+void FArticyNameIndex::FindFuzzy(const FString& Name, const int32 MaxDistance, TArray<FArticyNameMatch>& OutMatches, const int32 MaxResults) const
+{
+	const FString key = Name.ToUpper();
+	const int32 firstMatch = OutMatches.Num();
+
+	for (const FEntry& entry : Entries)
+	{
+		const int32 distance = GetBoundedEditDistance(key, entry.Key, MaxDistance);
+		if (distance <= MaxDistance)
+			OutMatches.Add({ entry.Name, distance });
+	}
+
+	// the entries are in alphabetical order, so a stable sort keeps matches with the same distance alphabetical
+	TArrayView<FArticyNameMatch> matches(OutMatches.GetData() + firstMatch, OutMatches.Num() - firstMatch);
+	Algo::StableSortBy(matches, &FArticyNameMatch::Distance);
+
+	if (MaxResults > 0 && matches.Num() > MaxResults)
+		OutMatches.SetNum(firstMatch + MaxResults);
+}
@@ -33,15 +33,20 @@ void UArticyObject::InitFromJson(TSharedPtr<FJsonValue> Json)
 
 	JSON_TRY_HEX_ID(obj, Parent);
 	JSON_TRY_STRING(obj, TechnicalName);
+	InternedTechnicalName = *TechnicalName;
 }
 
-//---------------------------------------------------------------------------//
-
-FName UArticyObject::GetTechnicalName() const
+void UArticyObject::PostLoad()
 {
-	return *TechnicalName;
+	Super::PostLoad();
+
+	// assets imported by older versions only stored the string
+	if (InternedTechnicalName.IsNone() && !TechnicalName.IsEmpty())
+		InternedTechnicalName = *TechnicalName;
 }
 
+//---------------------------------------------------------------------------//
+
 UArticyObject* UArticyObject::GetParent() const
 {
 	return UArticyDatabase::Get(this)->GetObject<UArticyObject>(Parent);
@@ -49,9 +54,16 @@ UArticyObject* UArticyObject::GetParent() const
 
 TArray<TWeakObjectPtr<UArticyObject>> UArticyObject::GetChildren() const
 {	
-	if (CachedChildren.Num() != Children.Num())
+	auto db = UArticyDatabase::Get(this);
+	if (!db)
+		return CachedChildren;
+
+	// children which are no articy objects (like pins) are never found, so the number of cached
+	// children can't tell if the cache is up to date; only look them up again if packages changed
+	const uint32 generation = db->GetObjectLookupGeneration();
+	if (CachedChildrenGeneration != generation)
 	{
-		auto db = UArticyDatabase::Get(this);
+		CachedChildrenGeneration = generation;
 		CachedChildren.Empty(Children.Num());
 
 		for (auto childId : Children)
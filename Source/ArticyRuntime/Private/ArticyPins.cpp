@@ -40,12 +40,26 @@ UArticyObject* UArticyFlowPin::GetOwner()
 	return ensure(db) ? db->GetObject<UArticyObject>(Owner) : nullptr;
 }
 
+int UArticyFlowPin::GetTextHash() const
+{
+	if(!CachedTextHash)
+		CachedTextHash = GetTypeHash(Text);
+
+	return CachedTextHash;
+}
+
 //---------------------------------------------------------------------------//
 
 bool UArticyInputPin::Evaluate(class UArticyGlobalVariables* GV, class UObject* MethodProvider)
 {
 	auto db = UArticyDatabase::Get(this);
-	return db->GetExpressoInstance()->Evaluate(GetTypeHash(Text), GV ? GV : db->GetGVs(), MethodProvider);
+	return db->GetExpressoInstance()->Evaluate(GetTextHash(), GV ? GV : db->GetGVs(), MethodProvider);
+}
+
+bool UArticyInputPin::GetConditionHash(int32& OutHash) const
+{
+	OutHash = GetTextHash();
+	return true;
 }
 
 void UArticyInputPin::Explore(UArticyFlowPlayer* Player, TArray<FArticyBranch>& OutBranches, const uint32& Depth)
@@ -99,7 +113,7 @@ void UArticyInputPin::Explore(UArticyFlowPlayer* Player, TArray<FArticyBranch>&
 void UArticyOutputPin::Execute(class UArticyGlobalVariables* GV, class UObject* MethodProvider)
 {
 	auto db = UArticyDatabase::Get(this);
-	db->GetExpressoInstance()->Execute(GetTypeHash(Text), GV ? GV : db->GetGVs(), MethodProvider);
+	db->GetExpressoInstance()->Execute(GetTextHash(), GV ? GV : db->GetGVs(), MethodProvider);
 }
 
 void UArticyOutputPin::Explore(UArticyFlowPlayer* Player, TArray<FArticyBranch>& OutBranches, const uint32& Depth)
@@ -18,6 +18,9 @@ UArticyPluginSettings::UArticyPluginSettings()
 	bKeepDatabaseBetweenWorlds = true;
 	bKeepGlobalVariablesBetweenWorlds = true;
 	bConvertUnityToUnrealRichText = false;
+	bExportTextsToStringTable = false;
+	bRecordChangeJournal = false;
+	ChangeJournalCapacity = 4096;
 	bVerifyArticyReferenceBeforeImport = true;
 	bUseLegacyImporter = false;
 	
@@ -0,0 +1,602 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "ArticyQuery.h"
+#include "ArticyDatabase.h"
+#include "ArticyExpressoScripts.h"
+#include "ArticyHelpers.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+
+namespace
+{
+	/** The game thread time ExecuteAsync spends on taking its snapshot per frame. */
+	constexpr double MaxSnapshotSecondsPerFrame = 0.002;
+
+	/**
+	 * Reads a (feature) property of objects as ExpressoType.
+	 * The property and its type are resolved once per class, so reading it again is a map lookup.
+	 * Only used on the game thread.
+	 */
+	class FArticyQueryPropertyReader
+	{
+	public:
+
+		explicit FArticyQueryPropertyReader(const FString& Path)
+		{
+			FString feature, property;
+			if (Path.Split(TEXT("."), &feature, &property))
+			{
+				FeatureName = *feature;
+				PropertyName = property;
+			}
+			else
+			{
+				PropertyName = Path;
+			}
+		}
+
+		bool Read(UArticyBaseObject* Object, ExpressoType& OutValue)
+		{
+			if (!Object)
+				return false;
+
+			UArticyBaseObject* holder = Object;
+			if (!FeatureName.IsNone())
+			{
+				const FResolved& feature = Resolve(FeatureProperties, Object, FeatureName);
+				auto featureProperty = CastField<FObjectPropertyBase>(feature.Property);
+				if (!featureProperty)
+					return false;
+
+				holder = Cast<UArticyBaseObject>(featureProperty->GetObjectPropertyValue_InContainer(Object));
+				if (!holder)
+					return false;
+			}
+
+			const FResolved& property = Resolve(Properties, holder, *PropertyName);
+			if (!property.Property || !property.Factory)
+				return false;
+
+			OutValue = property.Factory(holder, property.Property);
+			return true;
+		}
+
+	private:
+
+		struct FResolved
+		{
+			FProperty* Property = nullptr;
+			TFunction<ExpressoType(UArticyBaseObject*, FProperty*)> Factory;
+		};
+
+		static const FResolved& Resolve(TMap<const UClass*, FResolved>& Cache, UArticyBaseObject* Object, const FName& Name)
+		{
+			const UClass* cls = Object->GetClass();
+			if (const FResolved* resolved = Cache.Find(cls))
+				return *resolved;
+
+			FResolved resolved;
+			resolved.Property = Object->GetProperty(Name);
+			if (resolved.Property)
+				resolved.Factory = ExpressoType().GetDefinition(*resolved.Property->GetCPPType()).Factory;
+
+			return Cache.Add(cls, MoveTemp(resolved));
+		}
+
+		FName FeatureName;
+		FString PropertyName;
+		TMap<const UClass*, FResolved> FeatureProperties;
+		TMap<const UClass*, FResolved> Properties;
+	};
+
+	/** A condition with its value already converted, can be evaluated on any thread. */
+	struct FArticyQueryComparison
+	{
+		explicit FArticyQueryComparison(const FArticyQueryCondition& Condition)
+			: Operator(Condition.Operator), String(Condition.Value)
+		{
+			bIsNumber = LexTryParseString(Number, *String);
+			bBool = String.ToBool();
+			if (String.StartsWith(TEXT("0x")))
+				Id = ArticyHelpers::HexToUint64(String);
+			else if (String.IsNumeric())
+				Id = FCString::Strtoui64(*String, nullptr, 10);
+		}
+
+		bool Matches(const ExpressoType& Value) const
+		{
+			int32 comparison;
+			switch (Value.Type)
+			{
+			case ExpressoType::Bool:
+				comparison = static_cast<int32>(Value.GetBool()) - static_cast<int32>(bBool);
+				break;
+			case ExpressoType::Int:
+			case ExpressoType::Float:
+			{
+				if (!bIsNumber)
+					return false;
+				const double number = Value.Type == ExpressoType::Int ? static_cast<double>(Value.GetInt()) : Value.GetFloat();
+				comparison = number < Number ? -1 : (number > Number ? 1 : 0);
+				break;
+			}
+			case ExpressoType::String:
+				if (Operator == EArticyQueryOperator::StartsWith)
+					return Value.GetString().StartsWith(String);
+				if (Operator == EArticyQueryOperator::Contains)
+					return Value.GetString().Contains(String);
+				comparison = Value.GetString().Compare(String, ESearchCase::IgnoreCase);
+				break;
+			case ExpressoType::ObjectRef:
+				// references can only be compared for (in)equality
+				if (Operator != EArticyQueryOperator::Equal && Operator != EArticyQueryOperator::NotEqual)
+					return false;
+				comparison = Value.ObjectId == Id ? 0 : 1;
+				break;
+			default:
+				return false;
+			}
+
+			switch (Operator)
+			{
+			case EArticyQueryOperator::Equal: return comparison == 0;
+			case EArticyQueryOperator::NotEqual: return comparison != 0;
+			case EArticyQueryOperator::Less: return comparison < 0;
+			case EArticyQueryOperator::LessOrEqual: return comparison <= 0;
+			case EArticyQueryOperator::Greater: return comparison > 0;
+			case EArticyQueryOperator::GreaterOrEqual: return comparison >= 0;
+			default: return false;
+			}
+		}
+
+	private:
+		EArticyQueryOperator Operator;
+		FString String;
+		double Number = 0;
+		bool bIsNumber = false;
+		bool bBool = false;
+		uint64 Id = 0;
+	};
+
+	/** Orders values for sorting: numbers numerically, everything else by its text, values of different kinds by kind. */
+	bool IsLess(const ExpressoType& A, const ExpressoType& B)
+	{
+		const bool bNumberA = A.Type == ExpressoType::Int || A.Type == ExpressoType::Float;
+		const bool bNumberB = B.Type == ExpressoType::Int || B.Type == ExpressoType::Float;
+		if (bNumberA && bNumberB)
+		{
+			const double a = A.Type == ExpressoType::Int ? static_cast<double>(A.GetInt()) : A.GetFloat();
+			const double b = B.Type == ExpressoType::Int ? static_cast<double>(B.GetInt()) : B.GetFloat();
+			return a < b;
+		}
+
+		if (A.Type != B.Type)
+			return A.Type < B.Type;
+
+		switch (A.Type)
+		{
+		case ExpressoType::Bool:
+			return !A.GetBool() && B.GetBool();
+		case ExpressoType::String:
+			return A.GetString().Compare(B.GetString(), ESearchCase::IgnoreCase) < 0;
+		case ExpressoType::ObjectRef:
+			return A.ObjectId < B.ObjectId;
+		default:
+			return false;
+		}
+	}
+
+	/** An object matching the cheap checks, with the values needed to evaluate the conditions and to sort. */
+	struct FArticyQueryEntry
+	{
+		UArticyObject* Object = nullptr;
+		FArticyId Id;
+		TArray<ExpressoType, TInlineAllocator<4>> Values;
+		ExpressoType SortValue;
+	};
+
+	template<typename EntryType>
+	void SortAndPage(TArray<EntryType>& Entries, const bool bSort, const bool bDescending, const int32 Offset, const int32 Limit)
+	{
+		if (bSort)
+		{
+			Entries.StableSort([bDescending](const EntryType& A, const EntryType& B)
+			{
+				return bDescending ? IsLess(B.SortValue, A.SortValue) : IsLess(A.SortValue, B.SortValue);
+			});
+		}
+
+		const int32 first = FMath::Clamp(Offset, 0, Entries.Num());
+		const int32 num = Limit > 0 ? FMath::Min(Limit, Entries.Num() - first) : Entries.Num() - first;
+		if (first > 0)
+			Entries.RemoveAt(0, first);
+		Entries.SetNum(num);
+	}
+}
+
+//---------------------------------------------------------------------------//
+
+FArticyQuery& FArticyQuery::Where(const FString& Property, const EArticyQueryOperator Operator, const FString& Value)
+{
+	FArticyQueryCondition condition;
+	condition.Property = Property;
+	condition.Operator = Operator;
+	condition.Value = Value;
+	Conditions.Add(condition);
+
+	return *this;
+}
+
+FArticyQuery& FArticyQuery::Where(TFunction<bool(const UArticyObject*)> Predicate)
+{
+	Predicates.Add(MoveTemp(Predicate));
+	return *this;
+}
+
+TArray<UArticyObject*> FArticyQuery::Execute(const UArticyDatabase* Database) const
+{
+	TArray<UArticyObject*> result;
+	if (!Database)
+		return result;
+
+	TArray<FArticyQueryPropertyReader> readers;
+	TArray<FArticyQueryComparison> comparisons;
+	for (const auto& condition : Conditions)
+	{
+		readers.Emplace(condition.Property);
+		comparisons.Emplace(condition);
+	}
+
+	const bool bSort = !SortProperty.IsEmpty();
+	FArticyQueryPropertyReader sortReader(SortProperty);
+	TArray<FArticyQueryEntry> sorted;
+	int32 toSkip = Offset;
+
+	ForEachCandidate(Database, [&](UArticyObject* Object)
+	{
+		if (!MatchesObject(Object))
+			return true;
+
+		// conditions are checked in order, the first one which fails stops reading any further properties
+		for (int32 i = 0; i < comparisons.Num(); ++i)
+		{
+			ExpressoType value;
+			if (!readers[i].Read(Object, value) || !comparisons[i].Matches(value))
+				return true;
+		}
+
+		if (!MatchesPredicates(Object))
+			return true;
+
+		if (bSort)
+		{
+			FArticyQueryEntry entry;
+			entry.Object = Object;
+			sortReader.Read(Object, entry.SortValue);
+			sorted.Add(MoveTemp(entry));
+			return true;
+		}
+
+		if (toSkip > 0)
+		{
+			--toSkip;
+			return true;
+		}
+
+		// without sorting, the query is done as soon as the page is full
+		result.Add(Object);
+		return Limit <= 0 || result.Num() < Limit;
+	});
+
+	if (bSort)
+	{
+		SortAndPage(sorted, true, bSortDescending, Offset, Limit);
+
+		result.Reserve(sorted.Num());
+		for (const auto& entry : sorted)
+			result.Add(entry.Object);
+	}
+
+	return result;
+}
+
+struct FArticyQuery::FAsyncState
+{
+	using FRef = TSharedRef<FAsyncState, ESPMode::ThreadSafe>;
+
+	FAsyncState(const FArticyQuery& InQuery, UArticyDatabase* InDatabase, TFunction<void(const TArray<UArticyObject*>&)>&& InOnCompleted)
+		: Query(InQuery), Database(InDatabase), OnCompleted(MoveTemp(InOnCompleted)), SortReader(InQuery.SortProperty)
+	{
+		for (const auto& condition : Query.Conditions)
+			Readers.Emplace(condition.Property);
+	}
+
+	/** Takes the snapshot of the next candidates, and hands it to a worker once it is complete. Returns true while it isn't. */
+	static bool TakeSnapshot(const FRef& State);
+	/** Evaluates the conditions, sorting and paging on the snapshot, on a worker thread. */
+	static void Evaluate(const FRef& State);
+	/** Looks the matching objects up and runs the predicates, on the game thread. */
+	void Complete();
+
+	FArticyQuery Query;
+	TWeakObjectPtr<UArticyDatabase> Database;
+	TFunction<void(const TArray<UArticyObject*>&)> OnCompleted;
+
+	TArray<TWeakObjectPtr<UArticyCloneableObject>> Candidates;
+	int32 NextCandidate = 0;
+
+	TArray<FArticyQueryPropertyReader> Readers;
+	FArticyQueryPropertyReader SortReader;
+	TArray<FArticyQueryEntry> Entries;
+};
+
+bool FArticyQuery::FAsyncState::TakeSnapshot(const FRef& State)
+{
+	const UArticyDatabase* database = State->Database.Get();
+	if (!database)
+	{
+		State->OnCompleted(TArray<UArticyObject*>());
+		return false;
+	}
+
+	const bool bSort = !State->Query.SortProperty.IsEmpty();
+	const double endTime = FPlatformTime::Seconds() + MaxSnapshotSecondsPerFrame;
+	while (State->NextCandidate < State->Candidates.Num())
+	{
+		// reading the time isn't free either, so it's only checked every few objects
+		if (State->NextCandidate % 32 == 0 && FPlatformTime::Seconds() > endTime)
+			return true;
+
+		auto container = State->Candidates[State->NextCandidate++].Get();
+		auto obj = container ? container->Get(database, State->Query.CloneId) : nullptr;
+		if (!obj || !State->Query.MatchesObject(obj))
+			continue;
+
+		FArticyQueryEntry entry;
+		entry.Id = obj->GetId();
+		bool bRead = true;
+		for (auto& reader : State->Readers)
+		{
+			ExpressoType value;
+			bRead = reader.Read(obj, value);
+			if (!bRead)
+				break;
+			entry.Values.Add(value);
+		}
+		if (!bRead)
+			continue;
+
+		if (bSort)
+			State->SortReader.Read(obj, entry.SortValue);
+
+		State->Entries.Add(MoveTemp(entry));
+	}
+
+	State->Candidates.Empty();
+	Async(EAsyncExecution::ThreadPool, [State]()
+	{
+		Evaluate(State);
+		AsyncTask(ENamedThreads::GameThread, [State]() { State->Complete(); });
+	});
+	return false;
+}
+
+void FArticyQuery::FAsyncState::Evaluate(const FRef& State)
+{
+	TArray<FArticyQueryComparison> comparisons;
+	for (const auto& condition : State->Query.Conditions)
+		comparisons.Emplace(condition);
+
+	State->Entries.RemoveAll([&comparisons](const FArticyQueryEntry& Entry)
+	{
+		for (int32 i = 0; i < comparisons.Num(); ++i)
+		{
+			if (!comparisons[i].Matches(Entry.Values[i]))
+				return true;
+		}
+		return false;
+	});
+
+	// with predicates, the page is only known after they ran on the game thread
+	const FArticyQuery& query = State->Query;
+	const bool bPage = query.Predicates.Num() == 0;
+	SortAndPage(State->Entries, !query.SortProperty.IsEmpty(), query.bSortDescending, bPage ? query.Offset : 0, bPage ? query.Limit : 0);
+}
+
+void FArticyQuery::FAsyncState::Complete()
+{
+	TArray<UArticyObject*> result;
+	if (UArticyDatabase* database = Database.Get())
+	{
+		const bool bPaged = Query.Predicates.Num() == 0;
+		int32 toSkip = bPaged ? 0 : Query.Offset;
+		const int32 limit = bPaged ? 0 : Query.Limit;
+
+		result.Reserve(Entries.Num());
+		for (const auto& entry : Entries)
+		{
+			// the objects are looked up again, the database might have changed in the meantime
+			auto obj = database->GetObject(entry.Id, Query.CloneId);
+			if (!obj || !Query.MatchesPredicates(obj))
+				continue;
+
+			if (toSkip > 0)
+			{
+				--toSkip;
+				continue;
+			}
+
+			result.Add(obj);
+			if (limit > 0 && result.Num() >= limit)
+				break;
+		}
+	}
+
+	OnCompleted(result);
+}
+
+void FArticyQuery::ExecuteAsync(UArticyDatabase* Database, TFunction<void(const TArray<UArticyObject*>&)> OnCompleted) const
+{
+	check(IsInGameThread());
+
+	if (!Database)
+	{
+		OnCompleted(TArray<UArticyObject*>());
+		return;
+	}
+
+	FAsyncState::FRef state = MakeShared<FAsyncState, ESPMode::ThreadSafe>(*this, Database, MoveTemp(OnCompleted));
+
+	// only the containers are copied from the indexes right away, the objects are read in slices
+	ForEachCandidateContainer(Database, [&state](UArticyCloneableObject* Container)
+	{
+		state->Candidates.Add(Container);
+		return true;
+	});
+
+	// the first slice is taken immediately, so small queries don't wait for the next frame
+	if (FAsyncState::TakeSnapshot(state))
+	{
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([state](float)
+		{
+			return FAsyncState::TakeSnapshot(state);
+		}));
+	}
+}
+
+void FArticyQuery::ForEachCandidate(const UArticyDatabase* Database, TFunctionRef<bool(UArticyObject*)> Visitor) const
+{
+	ForEachCandidateContainer(Database, [&](UArticyCloneableObject* Container)
+	{
+		auto obj = Container->Get(Database, CloneId);
+		return !obj || Visitor(obj);
+	});
+}
+
+void FArticyQuery::ForEachCandidateContainer(const UArticyDatabase* Database, TFunctionRef<bool(UArticyCloneableObject*)> Visitor) const
+{
+	auto visitContainer = [&](UArticyCloneableObject* Container)
+	{
+		return !Container || Visitor(Container);
+	};
+
+	// start with the most selective index
+	if (!Parent.IsNull())
+	{
+		TArray<FArticyId, TInlineAllocator<16>> pending;
+		pending.Add(Parent);
+		for (int32 i = 0; i < pending.Num(); ++i)
+		{
+			auto children = Database->ObjectsByParent.Find(pending[i]);
+			if (!children)
+				continue;
+
+			for (auto container : *children)
+			{
+				if (!visitContainer(container))
+					return;
+
+				if (bIncludeSubtree)
+				{
+					if (auto original = container->Get(Database, 0, true))
+						pending.Add(original->GetId());
+				}
+			}
+		}
+		return;
+	}
+
+	if (ObjectClass || Feature)
+	{
+		auto classBucket = ObjectClass ? Database->ObjectsByClass.Find(ObjectClass.Get()) : nullptr;
+		auto featureBucket = Feature ? Database->ObjectsByClass.Find(Feature.Get()) : nullptr;
+		if ((ObjectClass && !classBucket) || (Feature && !featureBucket))
+			return;
+
+		auto bucket = !featureBucket || (classBucket && classBucket->Num() <= featureBucket->Num()) ? classBucket : featureBucket;
+		for (auto container : *bucket)
+		{
+			if (!visitContainer(container))
+				return;
+		}
+		return;
+	}
+
+	if (!NamePrefix.IsEmpty())
+	{
+		TArray<FName> names;
+		Database->GetNameIndex().FindWithPrefix(NamePrefix, names);
+		for (const FName& name : names)
+		{
+			for (auto container : Database->LoadedObjectsByName.FindChecked(name).Objects)
+			{
+				if (!visitContainer(container))
+					return;
+			}
+		}
+		return;
+	}
+
+	for (const auto& pair : Database->LoadedObjectsById)
+	{
+		if (!visitContainer(pair.Value))
+			return;
+	}
+}
+
+bool FArticyQuery::MatchesObject(const UArticyObject* Object) const
+{
+	if (ObjectClass && !Object->IsA(ObjectClass))
+		return false;
+	if (Feature && !Object->GetClass()->ImplementsInterface(Feature))
+		return false;
+	if (!NamePrefix.IsEmpty() && !Object->GetTechnicalNameString().StartsWith(NamePrefix))
+		return false;
+
+	return true;
+}
+
+bool FArticyQuery::MatchesPredicates(const UArticyObject* Object) const
+{
+	for (const auto& predicate : Predicates)
+	{
+		if (!predicate(Object))
+			return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------//
+
+UArticyQueryAsyncAction* UArticyQueryAsyncAction::RunArticyQueryAsync(const UObject* WorldContext, const FArticyQuery& Query)
+{
+	auto action = NewObject<UArticyQueryAsyncAction>();
+	action->Query = Query;
+	action->Database = UArticyDatabase::Get(WorldContext);
+	action->RegisterWithGameInstance(WorldContext);
+
+	return action;
+}
+
+void UArticyQueryAsyncAction::Activate()
+{
+	if (!Database.IsValid())
+	{
+		OnCompleted.Broadcast(TArray<UArticyObject*>());
+		SetReadyToDestroy();
+		return;
+	}
+
+	TWeakObjectPtr<UArticyQueryAsyncAction> weakThis = this;
+	Query.ExecuteAsync(Database.Get(), [weakThis](const TArray<UArticyObject*>& Objects)
+	{
+		if (weakThis.IsValid())
+		{
+			weakThis->OnCompleted.Broadcast(Objects);
+			weakThis->SetReadyToDestroy();
+		}
+	});
+}
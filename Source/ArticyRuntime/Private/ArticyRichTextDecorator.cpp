@@ -8,7 +8,7 @@
 #include "Components/PanelWidget.h"
 #include "Widgets/Input/SHyperlink.h"
 #include "Interfaces/ArticyHyperlinkHandler.h"
-#include "Internationalization/Regex.h"
+#include "ArticyMarkup.h"
 #include "ArticyDatabase.h"
 
 class FArticyRichTextDecorator : public FRichTextDecorator
@@ -27,6 +27,11 @@ public:
 		}
 	}
 
+	virtual ~FArticyRichTextDecorator() override
+	{
+		UnbindStyleTable();
+	}
+
 	virtual bool Supports(const FTextRunParseResults& RunParseResult, const FString& Text) const override
 	{
 		// Always true if color appears as an attribute
@@ -47,23 +52,16 @@ protected:
 		// Add text to string
 		InOutString += RunInfo.Content.ToString();
 
-		// Check if this style is defined in our table
-		UDataTable* StyleTable = GetStyleTable();
-		if (StyleTable)
+		// Check if this style is defined in our table, and if it is, use its text styling
+		if (const FTextBlockStyle* style = FindStyle(RunInfo.Name))
 		{
-			// If it is, use its text styling by copying the row in
-			const FRichTextStyleRow* row = StyleTable->FindRow<FRichTextStyleRow>(*RunInfo.Name, "ArticyStyleTableCheck");
-			if (row)
-			{
-				InOutTextStyle = row->TextStyle;
-			}
+			InOutTextStyle = *style;
 		}
 
-		// If we have a color attribute
-		if (RunInfo.MetaData.Contains(TEXT("color"))) {
-			// Change the style color
-			const FString color = RunInfo.MetaData[TEXT("color")];
-			InOutTextStyle.ColorAndOpacity = FSlateColor(FColor::FromHex(color));
+		// If we have a color attribute, change the style color
+		if (const FString* color = RunInfo.MetaData.Find(TEXT("color")))
+		{
+			InOutTextStyle.ColorAndOpacity = FindColor(*color);
 		}
     }
 #endif
@@ -76,9 +74,13 @@ protected:
 		// If this isn't a link, don't use this behavior 
 		if(Reference == nullptr) { return nullptr; }
 
+		// Use the target resolved on import, or parse the link once instead of on every layout
+		const FString* LinkId = RunInfo.MetaData.Find(ArticyMarkup::LinkIdMetaData);
+		const FArticyId target = FindLinkTarget(LinkId ? *LinkId : *Reference, LinkId != nullptr);
+
 		// Create delegate
 		FSimpleDelegate onNavigate;
-		onNavigate.BindUObject(Decorator, &UArticyRichTextDecorator::OnArticyLinkNavigated, Owner, *Reference);
+		onNavigate.BindUObject(Decorator, &UArticyRichTextDecorator::OnArticyLinkTargetNavigated, Owner, target);
 
 		// Create hyperlink with appropriate style
 		return SNew(SHyperlink)
@@ -102,6 +104,84 @@ private:
 		}
 		return *DataTableProp->ContainerPtrToValuePtr<UDataTable*>(Owner, 0);
 	}
+
+	// The styles of the rows of the style table, built once instead of finding the row for every run of every layout
+	mutable TMap<FName, FTextBlockStyle> Styles;
+	mutable TWeakObjectPtr<UDataTable> StyleTable;
+	mutable FDelegateHandle StyleTableChangedHandle;
+	mutable bool bStylesDirty = true;
+
+	// The parsed color and link metadata of the runs, as the same values are laid out again and again in dialogue logs
+	mutable TMap<FString, FSlateColor> Colors;
+	mutable TMap<FString, FArticyId> LinkTargets;
+
+	const FTextBlockStyle* FindStyle(const FString& RunName) const
+	{
+		UDataTable* table = GetStyleTable();
+		if (table != StyleTable.Get())
+		{
+			UnbindStyleTable();
+			StyleTable = table;
+			if (table)
+			{
+				// rows can be changed in the editor, or added and removed at runtime
+				StyleTableChangedHandle = table->OnDataTableChanged().AddRaw(this, &FArticyRichTextDecorator::OnStyleTableChanged);
+			}
+			bStylesDirty = true;
+		}
+
+		if (!table)
+			return nullptr;
+
+		if (bStylesDirty)
+		{
+			Styles.Reset();
+			table->ForeachRow<FRichTextStyleRow>(TEXT("ArticyStyleTableCheck"), [this](const FName& Key, const FRichTextStyleRow& Row)
+			{
+				Styles.Add(Key, Row.TextStyle);
+			});
+			bStylesDirty = false;
+		}
+
+		// names which were never used can't be rows of the table, so they are not added to the name table
+		const FName name(*RunName, FNAME_Find);
+		return name.IsNone() ? nullptr : Styles.Find(name);
+	}
+
+	const FSlateColor& FindColor(const FString& Hex) const
+	{
+		if (const FSlateColor* color = Colors.Find(Hex))
+			return *color;
+
+		return Colors.Add(Hex, FSlateColor(FColor::FromHex(Hex)));
+	}
+
+	FArticyId FindLinkTarget(const FString& Link, const bool bIsLinkId) const
+	{
+		if (const FArticyId* target = LinkTargets.Find(Link))
+			return *target;
+
+		FArticyId target;
+		if (bIsLinkId)
+			target = FCString::Strtoui64(*Link, nullptr, 10);
+		else
+			ArticyMarkup::ParseLinkTarget(Link, target);
+
+		return LinkTargets.Add(Link, target);
+	}
+
+	void OnStyleTableChanged() const
+	{
+		bStylesDirty = true;
+	}
+
+	void UnbindStyleTable() const
+	{
+		if (UDataTable* table = StyleTable.Get())
+			table->OnDataTableChanged().Remove(StyleTableChangedHandle);
+
+		StyleTableChangedHandle.Reset();
+	}
 };
 
 UArticyRichTextDecorator::UArticyRichTextDecorator(const FObjectInitializer& ObjectInitializer)
@@ -142,28 +222,32 @@ UObject* UArticyRichTextDecorator::GetHyperlinkHandler(URichTextBlock* RichTextB
 UArticyObject* UArticyRichTextDecorator::GetLinkDestination(URichTextBlock* Owner, const FString& Link)
 {
 	// Resolve the link text into an articy object
-	static FRegexPattern Pattern(TEXT("articy:\\/\\/localhost\\/view\\/~\\/(\\d+)"));
-	FRegexMatcher myMatcher(Pattern, Link);
-
-	// If the link doesn't match the expected format, abort.
-	if(!myMatcher.FindNext()) { return nullptr; }
-
-	// Get numeric id
-	FString Id = myMatcher.GetCaptureGroup(1);
-	uint64 id = FCString::Strtoui64(*Id, nullptr, 10);
+	FArticyId id;
+	if(!ArticyMarkup::ParseLinkTarget(Link, id)) { return nullptr; }
 
 	// Resolve
-	return UArticyDatabase::Get(Owner)->GetObject(id);
+	auto db = UArticyDatabase::Get(Owner);
+	return db ? db->GetObject(id) : nullptr;
 }
 
 void UArticyRichTextDecorator::OnArticyLinkNavigated(URichTextBlock* Parent, const FString Link)
+{
+	FArticyId id;
+	if(ArticyMarkup::ParseLinkTarget(Link, id))
+	{
+		OnArticyLinkTargetNavigated(Parent, id);
+	}
+}
+
+void UArticyRichTextDecorator::OnArticyLinkTargetNavigated(URichTextBlock* Parent, FArticyId Target)
 {
 	// Try to find a parent that implements the handler interface
 	auto Widget = GetHyperlinkHandler(Parent);
-	if(Widget == nullptr) { return; }
+	if(Widget == nullptr || Target.IsNull()) { return; }
 	
-	// Resolve the link text into an articy object
-	UArticyObject* Object = GetLinkDestination(Parent, Link);
+	// Resolve the target into an articy object
+	auto db = UArticyDatabase::Get(Parent);
+	UArticyObject* Object = db ? db->GetObject(Target) : nullptr;
 	if(!Object) { return; }
 
 	// Call handler
@@ -36,11 +36,23 @@ bool UArticyScriptCondition::Evaluate(class UArticyGlobalVariables* GV, class UO
 	return db->GetExpressoInstance()->Evaluate(GetExpressionHash(), GV ? GV : db->GetGVs(), MethodProvider);
 }
 
+bool UArticyScriptCondition::GetConditionHash(int32& OutHash) const
+{
+	OutHash = GetExpressionHash();
+	return true;
+}
+
 bool UArticyCondition::Evaluate(UArticyGlobalVariables* GV, UObject* MethodProvider)
 {
 	return !GetCondition() || GetCondition()->Evaluate(GV, MethodProvider);
 }
 
+bool UArticyCondition::GetConditionHash(int32& OutHash) const
+{
+	//without a script fragment there is no registered script, Evaluate returns true instead
+	return GetCondition() && GetCondition()->GetConditionHash(OutHash);
+}
+
 void UArticyCondition::Explore(UArticyFlowPlayer* Player, TArray<FArticyBranch>& OutBranches, const uint32& Depth)
 {
 	auto pins = GetOutputPinsPtr();
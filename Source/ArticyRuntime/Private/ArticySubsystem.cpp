@@ -0,0 +1,378 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "ArticySubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "ArticyDatabase.h"
+#include "ArticyGlobalVariables.h"
+#include "ArticyAlternativeGlobalVariables.h"
+#include "ArticyPluginSettings.h"
+#include "ArticyAsset.h"
+#include "ArticyPins.h"
+#include "ArticyFlowClasses.h"
+#include "ArticyBuiltinTypes.h"
+#include "ArticyScriptFragment.h"
+#include "Interfaces/ArticyInputPinsProvider.h"
+#include "Interfaces/ArticyOutputPinsProvider.h"
+#include "ArticyRuntimeModule.h"
+
+namespace
+{
+	/** Resolves the cached references and script hashes of a node and its pins which are needed to play it. */
+	void PrewarmNode(UArticyObject* Node)
+	{
+		if (auto condition = Cast<UArticyCondition>(Node))
+		{
+			if (auto script = condition->GetCondition())
+				script->GetExpressionHash();
+		}
+		else if (auto instruction = Cast<UArticyInstruction>(Node))
+		{
+			if (auto script = instruction->GetInstruction())
+				script->GetExpressionHash();
+		}
+		else if (auto jump = Cast<UArticyJump>(Node))
+		{
+			jump->GetTargetPin();
+		}
+
+		// input pins hold conditions and output pins instructions, so every node with pins has scripts
+		auto prewarmPins = [](const auto* Pins)
+		{
+			if (!Pins)
+				return;
+
+			for (const auto pin : *Pins)
+			{
+				pin->GetTextHash();
+				for (const auto connection : pin->Connections)
+					connection->GetTargetPin();
+			}
+		};
+
+		if (auto inputPinsProvider = Cast<IArticyInputPinsProvider>(Node))
+			prewarmPins(inputPinsProvider->GetInputPinsPtr());
+		if (auto outputPinsProvider = Cast<IArticyOutputPinsProvider>(Node))
+			prewarmPins(outputPinsProvider->GetOutputPinsPtr());
+	}
+
+	/** Calls Visitor for all nodes directly reachable from a node, including its children. */
+	void ForEachSuccessor(UArticyObject* Node, TFunctionRef<void(UArticyObject*)> Visitor)
+	{
+		auto visitPins = [&Visitor](const auto* Pins)
+		{
+			if (!Pins)
+				return;
+
+			for (const auto pin : *Pins)
+			{
+				for (const auto connection : pin->Connections)
+				{
+					if (auto target = Cast<UArticyObject>(connection->GetTarget()))
+						Visitor(target);
+				}
+			}
+		};
+
+		// connections of input pins lead to the children of a node
+		if (auto inputPinsProvider = Cast<IArticyInputPinsProvider>(Node))
+			visitPins(inputPinsProvider->GetInputPinsPtr());
+		if (auto outputPinsProvider = Cast<IArticyOutputPinsProvider>(Node))
+			visitPins(outputPinsProvider->GetOutputPinsPtr());
+
+		if (auto jump = Cast<UArticyJump>(Node))
+		{
+			if (auto target = Cast<UArticyObject>(jump->GetTarget()))
+				Visitor(target);
+		}
+	}
+}
+
+void UArticySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UArticyPluginSettings* settings = UArticyPluginSettings::Get();
+	bKeepDatabaseBetweenWorlds = settings->bKeepDatabaseBetweenWorlds;
+	bKeepGlobalVariablesBetweenWorlds = settings->bKeepGlobalVariablesBetweenWorlds;
+
+	// the instances kept between worlds don't need a world, so they are created while the game starts
+	if (bKeepDatabaseBetweenWorlds)
+		GetDatabase(nullptr);
+	if (bKeepGlobalVariablesBetweenWorlds)
+		GetGlobalVariables(nullptr);
+
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UArticySubsystem::OnWorldCleanup);
+}
+
+void UArticySubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+
+	ReleasePrewarmedAssets();
+	PersistentInstances = FArticyRuntimeInstances();
+	WorldInstances.Reset();
+
+	Super::Deinitialize();
+}
+
+UArticySubsystem* UArticySubsystem::Get(const UObject* WorldContext)
+{
+	const UWorld* world = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull);
+	const UGameInstance* gameInstance = world ? world->GetGameInstance() : nullptr;
+	return gameInstance ? gameInstance->GetSubsystem<UArticySubsystem>() : nullptr;
+}
+
+UArticyDatabase* UArticySubsystem::GetDatabase(UWorld* World)
+{
+	auto& instances = GetInstances(World, bKeepDatabaseBetweenWorlds);
+	if (!instances.Database)
+	{
+		UE_LOG(LogArticyRuntime, Log, TEXT("Cloning ArticyDatabase."));
+		UObject* outer = bKeepDatabaseBetweenWorlds ? static_cast<UObject*>(GetGameInstance()) : static_cast<UObject*>(World);
+		if (outer)
+			instances.Database = UArticyDatabase::CreateRuntimeInstance(outer);
+	}
+
+	return instances.Database;
+}
+
+UArticyGlobalVariables* UArticySubsystem::GetGlobalVariables(UWorld* World)
+{
+	auto& instances = GetInstances(World, bKeepGlobalVariablesBetweenWorlds);
+	if (!instances.GlobalVariables)
+	{
+		UE_LOG(LogArticyRuntime, Log, TEXT("Cloning GVs."));
+		if (bKeepGlobalVariablesBetweenWorlds)
+			instances.GlobalVariables = UArticyGlobalVariables::CreateRuntimeInstance(GetGameInstance(), UArticyGlobalVariables::GetMutableOriginal(), TEXT("Persistent Runtime GV"));
+		else if (World)
+			instances.GlobalVariables = UArticyGlobalVariables::CreateRuntimeInstance(World, UArticyGlobalVariables::GetMutableOriginal(), *FString::Printf(TEXT("%s GV"), *World->GetName()));
+	}
+
+	return instances.GlobalVariables;
+}
+
+UArticyGlobalVariables* UArticySubsystem::GetRuntimeGlobalVariables(UWorld* World, UArticyAlternativeGlobalVariables* Asset)
+{
+	if (!Asset)
+		return GetGlobalVariables(World);
+
+	const FString name = Asset->GetFullName();
+	auto& instances = GetInstances(World, bKeepGlobalVariablesBetweenWorlds);
+	auto& clone = instances.RuntimeGlobalVariables.FindOrAdd(*name);
+	if (!clone)
+	{
+		UE_LOG(LogArticyRuntime, Log, TEXT("Cloning Override GVs %s"), *name);
+		if (bKeepGlobalVariablesBetweenWorlds)
+			clone = UArticyGlobalVariables::CreateRuntimeInstance(GetGameInstance(), UArticyGlobalVariables::GetMutableOriginal(), *(TEXT("Persistent Runtime GV Clone of ") + name));
+		else if (World)
+			clone = UArticyGlobalVariables::CreateRuntimeInstance(World, UArticyGlobalVariables::GetMutableOriginal(), *FString::Printf(TEXT("%s %s GV"), *World->GetName(), *name));
+	}
+
+	return clone;
+}
+
+void UArticySubsystem::WarmUp(const UObject* WorldContext)
+{
+	UWorld* world = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::LogAndReturnNull);
+	if (!world)
+		return;
+
+	// creating the database also loads the default packages
+	if (auto db = GetDatabase(world))
+		db->GetExpressoInstance();
+	GetGlobalVariables(world);
+}
+
+void UArticySubsystem::PrewarmDialogue(const UObject* WorldContext, const TArray<FArticyRef>& StartNodes, int32 Depth, const FOnArticyDialoguePrewarmed& OnAssetsLoaded)
+{
+	UWorld* world = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::LogAndReturnNull);
+	if (!world)
+		return;
+
+	WarmUp(world);
+	const auto db = GetDatabase(world);
+	if (!db)
+		return;
+
+	// breadth first, so each node is prepared with the least number of hops it can be reached with
+	TSet<UArticyObject*> visited;
+	TArray<TPair<UArticyObject*, int32>> open;
+	for (const auto& ref : StartNodes)
+	{
+		auto node = db->GetObject(ref.GetId());
+		if (node && !visited.Contains(node))
+		{
+			visited.Add(node);
+			open.Emplace(node, 0);
+		}
+	}
+
+	TArray<UArticyAsset*> assets;
+	for (int32 i = 0; i < open.Num(); ++i)
+	{
+		UArticyObject* node = open[i].Key;
+		const int32 hops = open[i].Value;
+
+		PrewarmNode(node);
+		UArticyAsset::GetReferencedAssets(db, node, assets);
+
+		if (hops >= Depth)
+			continue;
+
+		ForEachSuccessor(node, [&](UArticyObject* Successor)
+		{
+			bool bAlreadyVisited = false;
+			visited.Add(Successor, &bAlreadyVisited);
+			if (!bAlreadyVisited)
+				open.Emplace(Successor, hops + 1);
+		});
+	}
+
+	TArray<FSoftObjectPath> paths;
+	for (const auto asset : assets)
+	{
+		if (!asset->GetAssetPath().IsNull() && !asset->GetLoadedAsset())
+			paths.Add(asset->GetAssetPath());
+	}
+
+	UE_LOG(LogArticyRuntime, Verbose, TEXT("Prewarmed %d articy nodes, loading %d assets."), open.Num(), paths.Num());
+
+	TSharedPtr<FStreamableHandle> handle;
+	if (paths.Num() > 0)
+	{
+		handle = StreamableManager.RequestAsyncLoad(paths, FStreamableDelegate::CreateLambda([OnAssetsLoaded]()
+		{
+			OnAssetsLoaded.ExecuteIfBound();
+		}));
+	}
+
+	// the handles of earlier calls for the same start nodes are replaced instead of accumulating
+	TArray<TSharedPtr<FStreamableHandle>> replaced;
+	for (const auto& ref : StartNodes)
+	{
+		TSharedPtr<FStreamableHandle> previous;
+		if (PrewarmHandles.RemoveAndCopyValue(ref.GetId(), previous) && previous != handle)
+			replaced.AddUnique(previous);
+		if (handle.IsValid())
+			PrewarmHandles.Add(ref.GetId(), handle);
+	}
+
+	// a handle is shared by the start nodes of one call, so it is only released once none of them uses it anymore
+	for (const auto& previous : replaced)
+	{
+		bool bInUse = false;
+		for (const auto& pair : PrewarmHandles)
+		{
+			if (pair.Value == previous)
+			{
+				bInUse = true;
+				break;
+			}
+		}
+
+		if (!bInUse)
+			previous->ReleaseHandle();
+	}
+
+	if (!handle.IsValid())
+		OnAssetsLoaded.ExecuteIfBound();
+}
+
+void UArticySubsystem::ReleasePrewarmedAssets()
+{
+	TArray<TSharedPtr<FStreamableHandle>> handles;
+	for (const auto& pair : PrewarmHandles)
+		handles.AddUnique(pair.Value);
+	PrewarmHandles.Reset();
+
+	for (const auto& handle : handles)
+		handle->ReleaseHandle();
+}
+
+bool UArticySubsystem::ReleaseDatabase(UArticyDatabase* Database)
+{
+	if (!Database)
+		return false;
+
+	if (PersistentInstances.Database == Database)
+	{
+		PersistentInstances.Database = nullptr;
+		return true;
+	}
+
+	for (auto& instances : WorldInstances)
+	{
+		if (instances.Database == Database)
+		{
+			instances.Database = nullptr;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UArticySubsystem::ReleaseGlobalVariables(UArticyGlobalVariables* GlobalVariables)
+{
+	if (!GlobalVariables)
+		return false;
+
+	auto release = [GlobalVariables](FArticyRuntimeInstances& Instances)
+	{
+		if (Instances.GlobalVariables == GlobalVariables)
+		{
+			Instances.GlobalVariables = nullptr;
+			return true;
+		}
+
+		for (auto it = Instances.RuntimeGlobalVariables.CreateIterator(); it; ++it)
+		{
+			if (it->Value == GlobalVariables)
+			{
+				it.RemoveCurrent();
+				return true;
+			}
+		}
+
+		return false;
+	};
+
+	if (release(PersistentInstances))
+		return true;
+
+	for (auto& instances : WorldInstances)
+	{
+		if (release(instances))
+			return true;
+	}
+
+	return false;
+}
+
+FArticyRuntimeInstances& UArticySubsystem::GetInstances(UWorld* World, const bool bKeepBetweenWorlds)
+{
+	if (bKeepBetweenWorlds || !World)
+		return PersistentInstances;
+
+	for (auto& instances : WorldInstances)
+	{
+		if (instances.World == World)
+			return instances;
+	}
+
+	auto& instances = WorldInstances.AddDefaulted_GetRef();
+	instances.World = World;
+	return instances;
+}
+
+void UArticySubsystem::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	// the instances of a world die with it
+	WorldInstances.RemoveAll([World](const FArticyRuntimeInstances& Instances)
+	{
+		return !Instances.World.IsValid() || Instances.World == World;
+	});
+}
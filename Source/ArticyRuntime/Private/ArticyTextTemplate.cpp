@@ -0,0 +1,220 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "ArticyTextTemplate.h"
+#include "ArticyGlobalVariables.h"
+#include "ArticyExpressoScripts.h"
+#include "ArticyDatabase.h"
+
+namespace
+{
+	bool IsTokenNameChar(const TCHAR Char)
+	{
+		return FChar::IsAlnum(Char) || Char == TEXT('_');
+	}
+
+	/** Returns the index of the closing brace of a token starting at Start, or INDEX_NONE if there is no valid token. */
+	int32 FindTokenEnd(const FString& Source, const int32 Start, int32& OutFirstDot)
+	{
+		const TCHAR* chars = *Source;
+		const int32 length = Source.Len();
+
+		// a token is at least two names separated by dots: {a.b}
+		OutFirstDot = INDEX_NONE;
+		bool bNameStart = true;
+		for (int32 i = Start + 1; i < length; ++i)
+		{
+			const TCHAR c = chars[i];
+			if (IsTokenNameChar(c))
+			{
+				bNameStart = false;
+			}
+			else if (c == TEXT('.') && !bNameStart)
+			{
+				if (OutFirstDot == INDEX_NONE)
+					OutFirstDot = i;
+				bNameStart = true;
+			}
+			else if (c == TEXT('}') && !bNameStart && OutFirstDot != INDEX_NONE)
+			{
+				return i;
+			}
+			else
+			{
+				return INDEX_NONE;
+			}
+		}
+
+		return INDEX_NONE;
+	}
+}
+
+void FArticyTextTemplate::Parse(const FString& InSource)
+{
+	Source = InSource;
+	Segments.Reset();
+	Tokens.Reset();
+	Invalidate();
+
+	const TCHAR* chars = *Source;
+	const int32 length = Source.Len();
+
+	int32 literalStart = 0;
+	for (int32 i = 0; i < length; ++i)
+	{
+		if (chars[i] != TEXT('{'))
+			continue;
+
+		int32 firstDot;
+		const int32 end = FindTokenEnd(Source, i, firstDot);
+		if (end == INDEX_NONE)
+			continue;
+
+		if (i > literalStart)
+			Segments.Add({ literalStart, i - literalStart, INDEX_NONE });
+
+		FToken token;
+		token.Scope = FName(*Source.Mid(i + 1, firstDot - i - 1));
+		token.Name = Source.Mid(firstDot + 1, end - firstDot - 1);
+
+		Segments.Add({ i, end + 1 - i, Tokens.Add(MoveTemp(token)) });
+
+		literalStart = end + 1;
+		i = end;
+	}
+
+	if (literalStart < length)
+		Segments.Add({ literalStart, length - literalStart, INDEX_NONE });
+}
+
+const FString& FArticyTextTemplate::Render(const UArticyDatabase* Database, bool* bOutChanged)
+{
+	if (bOutChanged)
+		*bOutChanged = false;
+
+	if (!HasTokens() || !Database)
+		return Source;
+
+	if (!bResolved || ResolvedGVs.Get() != Database->GetGVs() || ResolvedObjectGeneration != Database->GetObjectLookupGeneration())
+		Resolve(Database);
+	else if (!NeedsRender())
+		return Buffer;
+
+	if (bOutChanged)
+		*bOutChanged = true;
+
+	// the buffer keeps its allocation, so rendering the same template again usually doesn't allocate
+	Buffer.Reset();
+	for (const auto& segment : Segments)
+	{
+		if (segment.Token == INDEX_NONE || !AppendValue(Database, Tokens[segment.Token]))
+			Buffer.AppendChars(*Source + segment.Start, segment.Length);
+	}
+
+	return Buffer;
+}
+
+void FArticyTextTemplate::Invalidate()
+{
+	bResolved = false;
+	ResolvedGVs = nullptr;
+}
+
+void FArticyTextTemplate::Resolve(const UArticyDatabase* Database)
+{
+	auto gvs = Database->GetGVs();
+	ResolvedGVs = gvs;
+	ResolvedObjectGeneration = Database->GetObjectLookupGeneration();
+	bResolved = true;
+	bHasObjectTokens = false;
+
+	for (auto& token : Tokens)
+	{
+		token.Variable = nullptr;
+		token.RenderedChangeCount = 0;
+		token.bObject = false;
+
+		// the namespace is looked up directly, GetNamespace logs unknown namespaces as errors
+		auto set = gvs ? gvs->GetProp<UArticyBaseVariableSet*>(token.Scope) : nullptr;
+		if (auto variable = set ? set->GetPropPtr<UArticyVariable*>(*token.Name) : nullptr)
+			token.Variable = *variable;
+
+		if (token.Variable.IsValid())
+			continue;
+
+		// only tokens naming a property of a loaded object are rendered again every time, the rest are literals
+		auto propertyName = token.Name;
+		auto object = Database->GetObjectByName(token.Scope);
+		auto target = object ? ExpressoType::TryFeatureReroute(object, propertyName) : nullptr;
+		token.bObject = target && target->GetProperty(*propertyName);
+		bHasObjectTokens |= token.bObject;
+	}
+}
+
+bool FArticyTextTemplate::NeedsRender() const
+{
+	if (bHasObjectTokens)
+		return true;
+
+	for (const auto& token : Tokens)
+	{
+		// literals never change, but a variable which is gone has to be rendered as a literal now
+		if (token.Variable.IsExplicitlyNull())
+			continue;
+
+		auto variable = token.Variable.Get();
+		if (!variable || variable->GetChangeCount() != token.RenderedChangeCount)
+			return true;
+	}
+
+	return false;
+}
+
+bool FArticyTextTemplate::AppendValue(const UArticyDatabase* Database, FToken& Token)
+{
+	ExpressoType value;
+	if (auto variable = Token.Variable.Get())
+	{
+		Token.RenderedChangeCount = variable->GetChangeCount();
+
+		if (auto boolVar = Cast<UArticyBool>(variable))
+			value = ExpressoType(*boolVar);
+		else if (auto intVar = Cast<UArticyInt>(variable))
+			value = ExpressoType(*intVar);
+		else if (auto stringVar = Cast<UArticyString>(variable))
+			value = ExpressoType(*stringVar);
+		else if (auto floatVar = Cast<UArticyFloat>(variable))
+			value = ExpressoType(*floatVar);
+		else if (auto enumVar = Cast<UArticyEnum>(variable))
+			value = ExpressoType(*enumVar);
+	}
+	else if (!Token.bObject)
+	{
+		return false;
+	}
+	else if (auto object = Database->GetObjectByName(Token.Scope))
+	{
+		// objects are looked up on every render, so shadowed objects are never cached
+		// check the property first, reading a missing property is an error in expresso scripts
+		auto propertyName = Token.Name;
+		auto target = ExpressoType::TryFeatureReroute(object, propertyName);
+		if (target && target->GetProperty(*propertyName))
+			value = ExpressoType(target, propertyName);
+	}
+
+	switch (value.Type)
+	{
+	case ExpressoType::Bool:
+		Buffer += value.GetBool() ? TEXT("true") : TEXT("false");
+		return true;
+	case ExpressoType::String:
+		Buffer += value.GetString();
+		return true;
+	case ExpressoType::Undefined:
+		return false;
+	default:
+		Buffer += value.ToString();
+		return true;
+	}
+}
@@ -0,0 +1,12 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#include "Interfaces/ArticyObjectWithText.h"
+#include "ArticyDatabase.h"
+
+FText IArticyObjectWithText::GetFormattedText(const UObject* WorldContext) const
+{
+	auto database = UArticyDatabase::Get(WorldContext);
+	return database ? database->GetFormattedText(this) : GetText();
+}
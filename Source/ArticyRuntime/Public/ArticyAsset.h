@@ -9,8 +9,13 @@
 #include "FileMediaSource.h"
 #include "Sound/SoundWave.h"
 #include "Engine/Texture2D.h"
+#include "UObject/SoftObjectPath.h"
+#include "Engine/StreamableManager.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
 #include "ArticyAsset.generated.h"
 
+class UArticyDatabase;
+
 UENUM(BlueprintType)
 enum class EArticyAssetCategory : uint8
 {
@@ -40,6 +45,7 @@ class ARTICYRUNTIME_API UArticyAsset : public UArticyObject
 	GENERATED_BODY()
 
 public:
+	/** Returns the referenced asset, it is loaded synchronously if it isn't loaded yet. */
 	UFUNCTION(BlueprintCallable, Category="Load Asset")
 	UObject* LoadAsset() const;
 	
@@ -54,6 +60,38 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Load Asset")
 	UFileMediaSource* LoadAsFileMediaSource() const;
+
+	/** Returns the referenced asset if it is loaded already, without loading it. */
+	UFUNCTION(BlueprintCallable, Category = "Load Asset")
+	UObject* GetLoadedAsset() const;
+
+	/**
+	 * Loads the referenced asset in the background, and calls OnLoaded with it on the game thread (nullptr if it can't be loaded).
+	 * If the asset is loaded already, OnLoaded is called right away. In blueprints, use the Load Articy Asset Async node.
+	 * An asset loaded this way stays loaded until ReleaseAsset is called, or this object is destroyed.
+	 */
+	void LoadAssetAsync(TFunction<void(UObject*)> OnLoaded) const;
+
+	/** Allows the asset loaded by LoadAssetAsync to be garbage collected again, once nothing else uses it. */
+	UFUNCTION(BlueprintCallable, Category = "Load Asset")
+	void ReleaseAsset();
+
+	/** The path of the imported unreal asset. */
+	const FSoftObjectPath& GetAssetPath() const { return AssetPath; }
+
+	/** Computes the asset path from AssetRef. Called on import, as it depends on the plugin settings. */
+	void UpdateAssetPath();
+
+	virtual void PostLoad() override;
+	virtual void BeginDestroy() override;
+
+	/**
+	 * Adds the articy assets referenced by an object to OutAssets, unless they are contained already:
+	 * all asset ids in its properties, features and preview image, and those of its speaker.
+	 */
+	static void GetReferencedAssets(const UArticyDatabase* Database, const UObject* Object, TArray<UArticyAsset*>& OutAssets);
+	/** Same as above, but resolves ids with the given function instead of a database, e.g. while importing. */
+	static void GetReferencedAssets(const UObject* Object, TArray<UArticyAsset*>& OutAssets, TFunctionRef<UArticyObject*(const FArticyId&)> Resolve);
 	
 	/** The relative path of the referenced asset. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Meta Data")
@@ -63,6 +101,36 @@ public:
 	EArticyAssetCategory Category;
 
 private:
+	UPROPERTY(VisibleAnywhere, Category = "Meta Data")
+	FSoftObjectPath AssetPath;
+
 	UPROPERTY(Transient, VisibleAnywhere, Category = "Articy")
 	mutable TWeakObjectPtr<UObject> Asset = nullptr;
+
+	/** Keeps the asset loaded by LoadAssetAsync in memory. */
+	mutable TSharedPtr<FStreamableHandle> LoadHandle;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnArticyAssetLoaded, UObject*, Asset);
+
+/** Loads the asset referenced by an articy asset in the background, see UArticyAsset::LoadAssetAsync. */
+UCLASS()
+class ARTICYRUNTIME_API UArticyLoadAssetAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintAssignable)
+	FOnArticyAssetLoaded OnLoaded;
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContext", DisplayName = "Load Articy Asset Async"), Category = "Load Asset")
+	static UArticyLoadAssetAsyncAction* LoadArticyAssetAsync(const UObject* WorldContext, UArticyAsset* ArticyAsset);
+
+	virtual void Activate() override;
+
+private:
+
+	UPROPERTY()
+	UArticyAsset* ArticyAsset = nullptr;
 };
@@ -0,0 +1,182 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UArticyVariable;
+class UArticyBaseObject;
+struct ExpressoType;
+
+enum class EArticyJournalValueType : uint8
+{
+	None,
+	Bool,
+	Int,
+	Float,
+	String
+};
+
+/**
+ * A compact value stored in the change journal.
+ * Strings are not stored inline, but as index into the string pool of the journal.
+ * A pooled string is released once no entry stored in the journal references it anymore.
+ */
+struct ARTICYRUNTIME_API FArticyJournalValue
+{
+	FArticyJournalValue() : IntValue(0) {}
+
+	union
+	{
+		bool BoolValue;
+		int64 IntValue;
+		double FloatValue;
+		int32 StringIndex;
+	};
+
+	EArticyJournalValueType Type = EArticyJournalValueType::None;
+};
+
+/**
+ * A single recorded change of a global variable or an object property.
+ * All entries have the same size, no memory is allocated when recording them.
+ */
+struct ARTICYRUNTIME_API FArticyJournalEntry
+{
+	/** Increasing number of this entry, can be used to rewind the journal to this point. */
+	uint32 Sequence = 0;
+	/** The expression hash of the script fragment which caused the change, or 0 if it was changed from code or blueprint. */
+	int32 FragmentHash = 0;
+	/** The engine frame the change happened in. */
+	uint64 Frame = 0;
+
+	/** The changed variable, or the object owning the changed property. */
+	TWeakObjectPtr<UObject> Target;
+	/** The name of the changed property, None if a global variable was changed. */
+	FName Property;
+
+	/** The 'self' object of the script which caused the change, if any. */
+	TWeakObjectPtr<UObject> Self;
+	/** The 'speaker' of the script which caused the change, if any. */
+	TWeakObjectPtr<UObject> Speaker;
+
+	FArticyJournalValue OldValue;
+	FArticyJournalValue NewValue;
+
+	bool IsVariableChange() const { return Property.IsNone(); }
+};
+
+/**
+ * Records changes to global variables and object properties in a fixed size ring buffer.
+ * Once the buffer is full, the oldest entries are overwritten.
+ * The journal can be queried for past changes, and be rewound to undo all changes after a given entry.
+ */
+class ARTICYRUNTIME_API FArticyChangeJournal
+{
+public:
+
+	explicit FArticyChangeJournal(const int32 InCapacity);
+
+	void RecordVariable(UArticyVariable* Variable, const bool& OldValue, const bool& NewValue);
+	void RecordVariable(UArticyVariable* Variable, const int32& OldValue, const int32& NewValue);
+	void RecordVariable(UArticyVariable* Variable, const FString& OldValue, const FString& NewValue);
+	void RecordVariable(UArticyVariable* Variable, const float& OldValue, const float& NewValue);
+	void RecordProperty(UArticyBaseObject* Object, const FName& Property, const ExpressoType& OldValue, const ExpressoType& NewValue);
+
+	/** The number of entries currently stored in the journal. */
+	int32 Num() const { return Count; }
+	int32 GetCapacity() const { return Entries.Num(); }
+
+	/** Returns an entry by its age, 0 being the oldest entry still stored in the journal. */
+	const FArticyJournalEntry& GetEntry(const int32 Index) const;
+
+	/** The sequence number of the latest entry, or 0 if nothing was recorded yet. */
+	uint32 GetLatestSequence() const { return NextSequence - 1; }
+
+	/** Copies all entries with a sequence number greater than SinceSequence, oldest first. */
+	void GetEntries(TArray<FArticyJournalEntry>& OutEntries, const uint32 SinceSequence = 0) const;
+
+	/** Copies all entries matching the predicate, oldest first. */
+	void FindEntries(TFunctionRef<bool(const FArticyJournalEntry&)> Predicate, TArray<FArticyJournalEntry>& OutEntries) const;
+
+	/** Changes whenever entries are removed by RewindTo or Reset, so copies of the entries have to be refreshed. */
+	uint32 GetGeneration() const { return Generation; }
+
+	/** Returns a string stored in the string pool. Only valid while an entry referencing it is stored in the journal. */
+	const FString& GetString(const int32 Index) const;
+
+	/** Formats a value for display. Meant for debugging tools, it is never used while recording. */
+	FString ValueToString(const FArticyJournalValue& Value) const;
+
+	/**
+	 * Undoes all changes recorded after the entry with the given sequence number, newest first,
+	 * and removes them from the journal. Returns the number of changes which were undone.
+	 */
+	int32 RewindTo(const uint32 Sequence);
+
+	/** Removes all entries and pooled strings. */
+	void Reset();
+
+	/** Returns the journal of the instruction which is currently executed, if any. */
+	static FArticyChangeJournal* GetActive() { return Active; }
+
+private:
+
+	friend struct FArticyJournalScope;
+
+	/** Returns the next entry to write to, overwriting the oldest entry if the journal is full. */
+	FArticyJournalEntry* AddEntry(UObject* Target, const FName& Property);
+	FArticyJournalValue MakeValue(const ExpressoType& Value);
+	int32 InternString(const FString& String);
+	/** Releases the pooled string of a value which is removed from the journal. */
+	void ReleaseValue(FArticyJournalValue& Value);
+
+	void Undo(const FArticyJournalEntry& Entry);
+
+	/** The ring buffer. */
+	TArray<FArticyJournalEntry> Entries;
+	/** Index of the oldest entry in the ring buffer. */
+	int32 Head = 0;
+	int32 Count = 0;
+	uint32 NextSequence = 1;
+
+	/** String values are pooled, so repeated values don't need additional memory. */
+	TArray<FString> Strings;
+	TMap<FString, int32> StringIndices;
+	/** The number of entry values referencing each pooled string, and the released slots. */
+	TArray<int32> StringRefCounts;
+	TArray<int32> FreeStrings;
+
+	uint32 Generation = 0;
+
+	/** The script context of the current change. */
+	int32 CurrentFragmentHash = 0;
+	TWeakObjectPtr<UObject> CurrentSelf;
+	TWeakObjectPtr<UObject> CurrentSpeaker;
+
+	/** Prevents recording the changes made while rewinding. */
+	bool bIsRewinding = false;
+
+	static FArticyChangeJournal* Active;
+};
+
+/**
+ * Sets the script context (fragment, self and speaker) for all changes recorded while it is in scope.
+ * While a scope is alive, the journal is also used to record object property changes made by ExpressoType::SetValue.
+ */
+struct ARTICYRUNTIME_API FArticyJournalScope
+{
+	FArticyJournalScope(FArticyChangeJournal* InJournal, const int32 FragmentHash, UObject* Self, UObject* Speaker);
+	~FArticyJournalScope();
+
+private:
+
+	FArticyChangeJournal* Journal;
+	FArticyChangeJournal* PreviousActive;
+	int32 PreviousFragmentHash = 0;
+	TWeakObjectPtr<UObject> PreviousSelf;
+	TWeakObjectPtr<UObject> PreviousSpeaker;
+};
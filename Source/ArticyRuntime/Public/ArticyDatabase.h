@@ -9,13 +9,20 @@
 #include "ShadowStateManager.h"
 #include "ArticyObject.h"
 #include "ArticyPackage.h"
+#include "ArticyNameIndex.h"
+#include "ArticyTextTemplate.h"
 #include "AssetRegistry/AssetData.h"
+#include "UObject/ObjectKey.h"
 #include "ArticyDatabase.generated.h"
 
 class UArticyExpressoScripts;
+struct ExpressoType;
+struct FArticyCloneDelta;
 struct FArticyId;
 class UArticyGlobalVariables;
 class UArticyAlternativeGlobalVariables;
+class IArticyObjectWithText;
+class IArticyConditionProvider;
 
 USTRUCT(BlueprintType)
 struct FArticyObjectShadow
@@ -57,6 +64,9 @@ public:
 	 */
 	UArticyObject* Get(const IShadowStateManager* ShadowManager, bool ForceUnshadowed = false) const;
 
+	/** True while a shadow state with a shadow copy of this object is active. */
+	bool HasShadowCopies() const { return ShadowCopies.Num() > 1; }
+
 private:
 
 	/**
@@ -84,6 +94,7 @@ public:
 	/**
 	 * Get the clone of this object with a certain CloneId.
 	 * Returns nullptr if the clone does not exist.
+	 * Even though this is const, a delta clone is materialized, as a real object is needed to return it.
 	 */
 	UArticyObject* Get(const IShadowStateManager* ShadowManager, int32 CloneId = 0, bool bForceUnshadowed = false) const;
 	/**
@@ -92,6 +103,30 @@ public:
 	 * Otherwise, the existing clone is returned.
 	 */
 	UArticyObject* Clone(const IShadowStateManager* ShadowManager, int32 CloneId, bool bFailIfExists = true);
+	/**
+	 * Create a delta clone with the id CloneId, which only stores the property values changed with SetCloneProperty.
+	 * Reading its other properties reads them from the original. It is turned into a full clone as soon as
+	 * the clone object is requested with Get or Clone.
+	 * Returns the clone id, or INDEX_NONE if the clone already exists. If CloneId is -1, a free clone id is used.
+	 */
+	int32 CloneDelta(int32 CloneId = -1);
+	bool HasClone(int32 CloneId) const { return Clones.Contains(CloneId) || DeltaClones.Contains(CloneId); }
+	bool IsDeltaClone(int32 CloneId) const { return DeltaClones.Contains(CloneId); }
+
+	/** Read a property ("Property" or "Feature.Property") of a clone, without materializing delta clones. */
+	bool GetCloneProperty(const IShadowStateManager* ShadowManager, int32 CloneId, const FName& Property, ExpressoType& OutValue) const;
+	/**
+	 * Set a property ("Property" or "Feature.Property") of a clone. Delta clones store the value,
+	 * unless a shadow state is active or changes are recorded, which materializes the clone.
+	 */
+	bool SetCloneProperty(const IShadowStateManager* ShadowManager, int32 CloneId, const FName& Property, const ExpressoType& Value);
+	/**
+	 * Removes a clone, its CloneId is free to be used again.
+	 * The object is kept in a small pool and reset from the original when the next clone is created,
+	 * instead of duplicating the original again. The original (CloneId 0) can't be released,
+	 * and neither can a clone while it has a shadow copy.
+	 */
+	bool ReleaseClone(int32 CloneId);
 
 private:
 
@@ -102,8 +137,31 @@ private:
 	UPROPERTY(VisibleAnywhere, Category = "Articy")
 	TMap<int32, FArticyShadowableObject> Clones;
 
+	/** Released clones, waiting to be reused. */
+	UPROPERTY(Transient)
+	TArray<UArticyObject*> PooledClones;
+
+	/** Clones which were not materialized yet, see CloneDelta. */
+	TMap<int32, TSharedPtr<FArticyCloneDelta>> DeltaClones;
+
+	/** Released clone ids below NextCloneId, as a min-heap, so the lowest one is reused first. */
+	TArray<int32> FreeCloneIds;
+	/** All clone ids below this one are used or in FreeCloneIds. */
+	int32 NextCloneId = 0;
+
+	/** The maximum number of released clones kept for reuse. */
+	static constexpr int32 MaxPooledClones = 8;
+
 	/** Adds a clone to the Clones map. */
 	void AddClone(UArticyObject* Clone, int32 CloneId);
+	/** Resolves CloneId -1 to a free clone id, and marks the clone id as used. */
+	int32 AllocateCloneId(int32 CloneId);
+	/** Makes the id of a removed clone available to AllocateCloneId again. */
+	void FreeCloneId(int32 CloneId);
+	/** Creates a new clone object from the original, or resets a pooled one. */
+	UArticyObject* CreateCloneObject(const IShadowStateManager* ShadowManager);
+	/** Turns a delta clone into a full clone, applying its property values. */
+	void MaterializeDeltaClone(const IShadowStateManager* ShadowManager, int32 CloneId);
 };
 
 /**
@@ -119,6 +177,31 @@ public:
 	TArray<UArticyCloneableObject *> Objects;
 };
 
+/**
+ * A cached lookup of an object by id or technical name.
+ * The code generator creates one for every distinct literal getObj call in the expresso scripts,
+ * so the id is parsed at compile time and the object is only looked up once per database state.
+ */
+struct ARTICYRUNTIME_API FArticyObjectHandle
+{
+	explicit FArticyObjectHandle(const FArticyId& InId, const uint32 InCloneId = 0) : Id(InId), CloneId(InCloneId) {}
+	explicit FArticyObjectHandle(const FName& InName, const uint32 InCloneId = 0) : Name(InName), CloneId(InCloneId) {}
+
+	/** The id of the object, if it is looked up by id. */
+	FArticyId Id;
+	/** The technical name of the object, if it is looked up by name. */
+	FName Name;
+	uint32 CloneId = 0;
+
+private:
+
+	friend class UArticyDatabase;
+
+	/** The resolved object container, only valid if Generation matches the lookup generation of the database. */
+	mutable UArticyCloneableObject* Container = nullptr;
+	mutable uint32 Generation = 0;
+};
+
 /**
  * The database is used for accessing or cloning any articy object.
  */
@@ -133,8 +216,13 @@ public:
 
 	void Init();
 
-	/** Get the static instance of the database. */
+	/**
+	 * Get the runtime instance of the database.
+	 * In a game it is owned by the UArticySubsystem of the game instance.
+	 */
 	static UArticyDatabase* Get(const UObject* WorldContext);
+	/** Creates a new runtime instance from the database asset, with its default packages loaded. */
+	static UArticyDatabase* CreateRuntimeInstance(UObject* Outer);
 	/** Get the current GVs instance. */
 	virtual UArticyGlobalVariables* GetGVs() const;
 	/** Gets the current runtime instance of a set of GVs */
@@ -181,11 +269,18 @@ public:
 	/** Load all imported packages. */
 	virtual void LoadAllPackages(bool bDefaultOnly = false);
 
-	/** Load a package of a given name. */
+	/**
+	 * Load a package of a given name.
+	 * If bLoadMediaBundle is set, the media bundle of the package (see UArticyPackage) is also loaded in the background
+	 * through the asset manager, and kept loaded until the package is unloaded.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "Articy")
-	virtual void LoadPackage(FString PackageName);
+	virtual void LoadPackage(FString PackageName, bool bLoadMediaBundle = false);
 
-	/** Load a package of a given name. */
+	/**
+	 * Unload a package of a given name.
+	 * Objects which are also contained in another loaded package stay loaded, unless bQuickUnload is set.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "Articy")
 	virtual bool UnloadPackage(const FString PackageName, const bool bQuickUnload);
 
@@ -195,6 +290,7 @@ public:
 	 * Get an object by its Id.
 	 * If a CloneId other than 0 is provided, a copy of the object with this index must exist.
 	 * Otherwise a null-pointer is returned.
+	 * Even though this is const, a delta clone is materialized (turned into a full clone) when it is returned.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Articy", meta=(DeterminesOutputType="CastTo", AdvancedDisplay="CloneId"))
 	UArticyObject* GetObject(FArticyId Id, int32 CloneId = 0, TSubclassOf<class UArticyObject> CastTo = NULL) const;
@@ -211,7 +307,7 @@ public:
 	/**
 	 * Get an object by its TechnicalName.
 	 * If a CloneId other than 0 is provided, a copy of the object with this index must exist,
-	 * otherwise a null-pointer is returned.
+	 * otherwise a null-pointer is returned. Delta clones are materialized, like with GetObject.
 	 * Note that the TechnicalName is not unique! This will take the first matching object.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Articy", meta=(DeterminesOutputType="CastTo", AdvancedDisplay="CloneId"))
@@ -219,6 +315,25 @@ public:
 	template<typename T> 
 	T* GetObjectByName(FName TechnicalName, int32 CloneId = 0) const { return Cast<T>(GetObjectByName(TechnicalName, CloneId)); }
 
+	/**
+	 * Get an object by a cached handle, see FArticyObjectHandle.
+	 * The lookup is only done again if packages were loaded or unloaded since the handle was last resolved.
+	 */
+	UArticyObject* GetObject(const FArticyObjectHandle& Handle) const;
+
+	/**
+	 * Changes whenever the set of loaded objects changes.
+	 * It is unique among all database instances, so cached lookups of one database are never used by another.
+	 */
+	uint32 GetObjectLookupGeneration() const;
+
+
+	/**
+	 * Returns the text of an object with its tokens replaced by their current values, see FArticyTextTemplate.
+	 * The text is parsed on first use and cached per object, and parsed again if it changed (e.g. with the culture).
+	 * The result is only rendered again if a variable it references changed.
+	 */
+	FText GetFormattedText(const IArticyObjectWithText* Object) const;
 
 	/****
 	* Get an object by its Articy String Representation.
@@ -247,10 +362,36 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Articy", meta = (DeterminesOutputType = "CastTo", AdvancedDisplay = "CloneId"))
 	TArray<UArticyObject*> GetObjects(FName TechnicalName, int32 CloneId = 0, TSubclassOf<class UArticyObject> CastTo = NULL) const;
 
+	/**
+	 * Get the technical names of all loaded objects starting with Prefix, ignoring case, in alphabetical order.
+	 * A MaxResults of 0 returns all of them.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Articy", meta = (AdvancedDisplay = "MaxResults"))
+	TArray<FName> FindNamesWithPrefix(const FString& Prefix, int32 MaxResults = 0) const;
+
+	/**
+	 * Get all objects whose technical name starts with Prefix, ignoring case.
+	 * If a CloneId other than 0 is provided, copies of the objects with this index must exist,
+	 * otherwise they will be not added to the result. Delta clones are materialized, like with GetObject.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Articy", meta = (AdvancedDisplay = "CloneId"))
+	TArray<UArticyObject*> GetObjectsWithNamePrefix(const FString& Prefix, int32 CloneId = 0) const;
+
+	/**
+	 * Get the technical names of all loaded objects which differ from Name by at most MaxDistance typos
+	 * (inserted, removed or replaced characters, ignoring case), closest first.
+	 * Meant for debug consoles and tools, as it compares Name with every loaded name.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Articy", meta = (AdvancedDisplay = "MaxDistance,MaxResults"))
+	TArray<FName> FindSimilarNames(const FString& Name, int32 MaxDistance = 2, int32 MaxResults = 10) const;
+
+	/** The index of the technical names of all loaded objects, it is rebuilt on demand after packages were loaded or unloaded. */
+	const FArticyNameIndex& GetNameIndex() const;
+
 	/**
 	* Get all objects with a given Type.
 	* If a CloneId other than 0 is provided, copies of the objects with this index must exist,
-	* otherwise they will be not added to the result.
+	* otherwise they will be not added to the result. Delta clones are materialized, like with GetObject.
 	*/
 	template<typename T>
 	TArray<T*> GetObjectsOfClass(int32 CloneId = 0) const;
@@ -258,11 +399,27 @@ public:
 	/**
 	* Get all objects with a given Type.
 	* If a CloneId other than 0 is provided, copies of the objects with this index must exist,
-	* otherwise they will be not added to the result.
+	* otherwise they will be not added to the result. Delta clones are materialized, like with GetObject.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Articy", meta=(DeterminesOutputType = "Class", AdvancedDisplay="CloneId"))
 	TArray<UArticyObject*> GetObjectsOfClass(TSubclassOf<class UArticyObject> Class, int32 CloneId = 0) const;
 
+	/**
+	* Get all objects which have a certain feature, i.e. implement its generated feature interface.
+	* If a CloneId other than 0 is provided, copies of the objects with this index must exist,
+	* otherwise they will be not added to the result. Delta clones are materialized, like with GetObject.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Articy", meta=(AdvancedDisplay="CloneId"))
+	TArray<UArticyObject*> GetObjectsWithFeature(TSubclassOf<UInterface> Feature, int32 CloneId = 0) const;
+
+	/**
+	* Get all loaded objects whose parent is the object with the given id, in the order they were loaded.
+	* If a CloneId other than 0 is provided, copies of the objects with this index must exist,
+	* otherwise they will be not added to the result. Delta clones are materialized, like with GetObject.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Articy", meta=(AdvancedDisplay="CloneId"))
+	TArray<UArticyObject*> GetChildrenOf(FArticyId ParentId, int32 CloneId = 0) const;
+
 	/**
 	* Get all objects.
 	*/
@@ -282,7 +439,7 @@ public:
 	/**
 	 * Clone an existing object, and assign the NewCloneId to it.
 	 * If the clone already exists, nullptr is returned!
-	 * If NewCloneId is -1, the next free clone Id will be used.
+	 * If NewCloneId is -1, a free clone Id will be used, preferring the lowest released one.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Articy", meta=(DeterminesOutputType = "CastTo"))
 	UArticyObject* CloneFrom(FArticyId Id, int32 NewCloneId = -1, TSubclassOf<class UArticyObject> CastTo = NULL);
@@ -292,7 +449,7 @@ public:
 	/**
 	 * Clone an existing object, and assign the NewCloneId to it.
 	 * If the clone already exists, nullptr is returned!
-	 * If NewCloneId is -1, the next free clone Id will be used.
+	 * If NewCloneId is -1, a free clone Id will be used, preferring the lowest released one.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Articy", meta=(DeterminesOutputType = "CastTo"))
 	UArticyObject* CloneFromByName(FName TechnicalName, int32 NewCloneId = -1, TSubclassOf<class UArticyObject> CastTo = NULL);
@@ -315,6 +472,29 @@ public:
 	template<typename T>
 	T* GetOrClone(const FName& TechnicalName, int32 NewCloneId) { return Cast<T>(GetOrCloneByName(TechnicalName, NewCloneId)); }
 
+	/**
+	 * Release a clone created by CloneFrom or GetOrClone, see UArticyCloneableObject::ReleaseClone.
+	 * Returns false if there is no such clone, or it can't be released.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Articy")
+	bool ReleaseClone(FArticyId Id, int32 CloneId);
+
+	/**
+	 * Create a delta clone of an object, which only stores the properties changed with SetCloneProperty
+	 * instead of a full copy of the object and its features; see UArticyCloneableObject::CloneDelta.
+	 * Getting the clone object with GetObject turns it into a full clone.
+	 * Returns the clone id, or INDEX_NONE if the object or clone doesn't exist.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Articy")
+	int32 CloneDelta(FArticyId Id, int32 NewCloneId = -1);
+
+	/** Whether the clone of an object is a delta clone, which was not materialized yet. */
+	bool IsDeltaClone(FArticyId Id, int32 CloneId) const;
+	/** Read a property ("Property" or "Feature.Property") of a clone, without materializing delta clones. */
+	bool GetCloneProperty(FArticyId Id, int32 CloneId, const FName& Property, ExpressoType& OutValue) const;
+	/** Set a property ("Property" or "Feature.Property") of a clone, delta clones only store the new value. */
+	bool SetCloneProperty(FArticyId Id, int32 CloneId, const FName& Property, const ExpressoType& Value);
+
 	//---------------------------------------------------------------------------//
 
 	/**
@@ -323,6 +503,17 @@ public:
 	 */
 	UArticyExpressoScripts* GetExpressoInstance() const;
 
+	/**
+	 * Evaluates many independent conditions (script conditions, condition nodes or input pins) at once, e.g. for quest markers.
+	 * The GV instance and method provider are only set up once, instead of once per condition.
+	 * If GV is null, the current GVs are used. OutResults gets one result per condition, null conditions are true.
+	 */
+	void EvaluateConditionsBatch(TArrayView<IArticyConditionProvider* const> Conditions, UArticyGlobalVariables* GV, UObject* MethodProvider, TArray<bool>& OutResults);
+
+	/** Evaluates many conditions at once, see EvaluateConditionsBatch. Objects which have no condition are true. */
+	UFUNCTION(BlueprintCallable, Category = "Script Methods", meta = (AdvancedDisplay = "GV, MethodProvider"))
+	void EvaluateConditions(const TArray<UObject*>& Conditions, UArticyGlobalVariables* GV, UObject* MethodProvider, TArray<bool>& OutResults);
+
 	static TWeakObjectPtr<UArticyDatabase> GetMutableOriginal();
 
 	void ChangePackageDefault(FName PackageName, bool bIsDefaultPackage);
@@ -348,6 +539,9 @@ protected:
 
 private:
 
+	/** Queries run directly against the indexes. */
+	friend struct FArticyQuery;
+
 	static TMap<TWeakObjectPtr<UWorld>, TWeakObjectPtr<UArticyDatabase>> Clones;
 	static TWeakObjectPtr<UArticyDatabase> PersistentClone;
 
@@ -360,6 +554,52 @@ private:
 
 	UArticyObject* GetObjectInternal(FArticyId Id, int32 CloneId = 0, bool bForceUnshadowed = false) const;
 
+	/** The number of loaded packages containing each loaded object, it is unloaded when this drops to zero. */
+	TMap<FArticyId, int32> LoadedObjectPackageCounts;
+
+	/** Loads and unloads the media bundle of a package through the asset manager. */
+	void LoadPackageMedia(const UArticyPackage* Package);
+	void UnloadPackageMedia(const FString& PackageName);
+
+	/** The packages whose media bundle was loaded by LoadPackage. */
+	TMap<FString, FPrimaryAssetId> LoadedPackageMedia;
+
+	/** The text templates of the objects whose text was formatted, see GetFormattedText. */
+	mutable TMap<FObjectKey, FArticyFormattedText> FormattedTexts;
+	/** FormattedTexts is pruned when it grows to this size, so entries of destroyed shadow copies don't pile up. */
+	mutable int32 FormattedTextsPruneSize = 64;
+
+	/** Removes the formatted texts of objects which were destroyed or unloaded. */
+	void PruneFormattedTexts() const;
+
+	/**
+	 * Secondary indexes, updated whenever packages are loaded or unloaded.
+	 * Objects are added to the bucket of their class, all its super classes up to UArticyObject
+	 * and all implemented feature interfaces. As every template is a generated class, this also
+	 * indexes objects by template.
+	 */
+	TMap<const UClass*, TSet<UArticyCloneableObject*>> ObjectsByClass;
+	TMap<FArticyId, TArray<UArticyCloneableObject*>> ObjectsByParent;
+
+	void AddToIndexes(UArticyCloneableObject* Container, const UArticyObject* Object);
+	/**
+	 * Rebuilds the indexes and the package counts from the loaded objects and packages,
+	 * as they are not copied when the database is duplicated.
+	 */
+	void RebuildIndexes();
+	void RemoveFromIndexes(UArticyCloneableObject* Container, const UArticyObject* Object);
+	void GetIndexedObjects(const UClass* Class, int32 CloneId, TArray<UArticyObject*>& OutObjects) const;
+
+	/** Invalidates all cached object handles, called when objects are loaded or unloaded. */
+	void InvalidateObjectLookups() { ObjectLookupGeneration = 0; }
+
+	mutable uint32 ObjectLookupGeneration = 0;
+
+	mutable FArticyNameIndex NameIndex;
+	/** The object lookup generation the name index was built for. */
+	mutable uint32 NameIndexGeneration = 0;
+	static uint32 NextObjectLookupGeneration;
+
 	/** Get the original asset (on disk) of the database. */
 	static const UArticyDatabase* GetOriginal(bool bLoadDefaultPackages = false);
 
@@ -385,21 +625,31 @@ TArray<T*> UArticyDatabase::GetObjects(FName TechnicalName, int32 CloneId) const
 	return Array;
 }
 
+/** The class objects of type T are indexed by, which for feature interfaces is the UInterface class. */
+template<typename T, bool bIsInterface = TIsIInterface<T>::Value>
+struct TArticyIndexedClass
+{
+	static UClass* Get() { return T::StaticClass(); }
+};
+
+template<typename T>
+struct TArticyIndexedClass<T, true>
+{
+	static UClass* Get() { return T::UClassType::StaticClass(); }
+};
+
 template<typename T>
 TArray<T*> UArticyDatabase::GetObjectsOfClass(int32 CloneId) const
 {
 	TArray<T*> arr;
 
-	TArray<UArticyCloneableObject*> ArticyObjects;
-	LoadedObjectsById.GenerateValueArray(ArticyObjects);
+	auto bucket = ObjectsByClass.Find(TArticyIndexedClass<T>::Get());
+	if (!bucket)
+		return arr;
 
-	for (auto obj : ArticyObjects)
+	arr.Reserve(bucket->Num());
+	for (auto obj : *bucket)
 	{
-		/*if (obj->GetCloneId() == CloneId && Cast<T>(obj))
-		{
-			arr.Add(obj);
-		}*/
-
 		UArticyObject* Object = obj->Get(this, CloneId, false);
 		if(Object)
 		{
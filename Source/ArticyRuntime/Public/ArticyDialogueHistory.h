@@ -0,0 +1,193 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ArticyBaseTypes.h"
+#include "ArticyDialogueHistory.generated.h"
+
+class UArticyObject;
+class UArticyFlowPlayer;
+class UArticyDialogueHistoryComponent;
+class UArticyDialogueHistoryItem;
+class IArticyFlowObject;
+struct FArticyBranch;
+
+/** A node the flow player paused on. Objects are only stored by id, so the history doesn't keep them loaded. */
+USTRUCT(BlueprintType)
+struct ARTICYRUNTIME_API FArticyDialogueHistoryEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, SaveGame, Category = "Articy")
+	FArticyId Node;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, SaveGame, Category = "Articy")
+	int32 CloneId = 0;
+
+	/** The speaker of the node, if it has one. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, SaveGame, Category = "Articy")
+	FArticyId Speaker;
+
+	/** The index of the branch played to leave the node, or -1 if none was played yet. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, SaveGame, Category = "Articy")
+	int32 BranchIndex = -1;
+
+	/** The game time in seconds when the player paused on the node. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, SaveGame, Category = "Articy")
+	float Timestamp = 0.f;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnArticyDialogueHistoryChanged, UArticyDialogueHistoryComponent*, History);
+
+/**
+ * Records the nodes a flow player pauses on, and the branches played to leave them.
+ * The entries are kept in a ring buffer of fixed capacity, adding an entry never allocates and overwrites the oldest one
+ * once the history is full. The entries are SaveGame properties, and can also be saved with GetEntries and RestoreEntries.
+ *
+ * To show the history in a list view, pass the items returned by GetListItems to SetListItems, again whenever OnHistoryChanged
+ * is broadcast. Every entry has its own item for as long as it is in the history, and entries added later (also those which
+ * overwrite the oldest entry) get new items, so a visible row never shows another entry than the one it was created for.
+ * The items only look up their node and speaker when GetNode or GetSpeaker is called, i.e. when an entry widget is created
+ * for a visible row.
+ */
+UCLASS(BlueprintType, ClassGroup="Articy", meta=(BlueprintSpawnableComponent))
+class ARTICYRUNTIME_API UArticyDialogueHistoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	/** After loading, the entries get new list items like restored entries do, so GetListItems has to be called again. */
+	virtual void Serialize(FArchive& Ar) override;
+
+	/** Records the pauses of a flow player, unbinding the previous one. Called with the flow player of the owner on BeginPlay if none is set. */
+	UFUNCTION(BlueprintCallable, Category = "Setup")
+	void SetFlowPlayer(UArticyFlowPlayer* NewFlowPlayer);
+
+	UFUNCTION(BlueprintPure, Category = "Setup")
+	UArticyFlowPlayer* GetFlowPlayer() const { return FlowPlayer; }
+
+	/** Changes the capacity, keeping the newest entries. */
+	UFUNCTION(BlueprintCallable, Category = "Setup")
+	void SetCapacity(int32 NewCapacity);
+
+	UFUNCTION(BlueprintPure, Category = "Setup")
+	int32 GetCapacity() const { return Capacity; }
+
+	//---------------------------------------------------------------------------//
+
+	UFUNCTION(BlueprintCallable, Category = "History")
+	void AddEntry(const FArticyDialogueHistoryEntry& Entry);
+
+	UFUNCTION(BlueprintCallable, Category = "History")
+	void Clear();
+
+	UFUNCTION(BlueprintPure, Category = "History")
+	int32 GetNumEntries() const { return Count; }
+
+	/** Returns an entry, the oldest one has index 0. */
+	UFUNCTION(BlueprintPure, Category = "History")
+	FArticyDialogueHistoryEntry GetEntry(int32 Index) const;
+
+	const FArticyDialogueHistoryEntry* FindEntry(const int32 Index) const;
+
+	/** Returns all entries, oldest first. */
+	UFUNCTION(BlueprintCallable, Category = "History")
+	TArray<FArticyDialogueHistoryEntry> GetEntries() const;
+
+	/** Replaces the entries, e.g. with the ones returned by GetEntries before saving. Only the newest entries are kept if there are more than fit. */
+	UFUNCTION(BlueprintCallable, Category = "History")
+	void RestoreEntries(const TArray<FArticyDialogueHistoryEntry>& NewEntries);
+
+	/** Returns one item per entry, oldest first, to pass to a list view. An entry keeps its item until it is removed from the history. */
+	UFUNCTION(BlueprintCallable, Category = "History")
+	void GetListItems(TArray<UObject*>& OutItems);
+
+	/** Broadcast whenever entries were added or removed. */
+	UPROPERTY(BlueprintAssignable, Category = "History")
+	FOnArticyDialogueHistoryChanged OnHistoryChanged;
+
+protected:
+
+	/** The maximum number of entries, older entries are overwritten once it is reached. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Setup", meta = (ClampMin = 1))
+	int32 Capacity = 256;
+
+	/** The flow player whose pauses are recorded. If it is not set, the flow player of the owner is used. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Setup")
+	UArticyFlowPlayer* FlowPlayer = nullptr;
+
+private:
+
+	friend UArticyDialogueHistoryItem;
+
+	UFUNCTION()
+	void OnPlayerPaused(TScriptInterface<IArticyFlowObject> PausedOn);
+	void OnBranchPlayed(UArticyFlowPlayer* Player, const FArticyBranch& Branch);
+
+	void BindFlowPlayer();
+	void UnbindFlowPlayer();
+
+	/** The ring buffer, its size is the capacity once the first entry was added. */
+	UPROPERTY(SaveGame)
+	TArray<FArticyDialogueHistoryEntry> Entries;
+
+	/** The slot of the oldest entry. */
+	UPROPERTY(SaveGame)
+	int32 Head = 0;
+
+	UPROPERTY(SaveGame)
+	int32 Count = 0;
+
+	/** The sequence number of the next entry, the entry at index i has the number NextSequence - Count + i. */
+	int64 NextSequence = 0;
+
+	/** Used to skip pauses on the same node, e.g. when the branches are updated, unless a branch was played in between. */
+	bool bBranchPlayed = true;
+
+	FDelegateHandle BranchPlayedHandle;
+
+	/** The list items of the entries, oldest first. */
+	UPROPERTY(Transient)
+	TArray<UArticyDialogueHistoryItem*> ListItems;
+};
+
+/** A row of a dialogue history in a list view, see UArticyDialogueHistoryComponent::GetListItems. */
+UCLASS(BlueprintType)
+class ARTICYRUNTIME_API UArticyDialogueHistoryItem : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Returns the entry shown in this row. */
+	UFUNCTION(BlueprintPure, Category = "History")
+	FArticyDialogueHistoryEntry GetEntry() const;
+
+	/** Looks up the node of the entry, the result is cached. */
+	UFUNCTION(BlueprintCallable, Category = "History")
+	UArticyObject* GetNode();
+
+	/** Looks up the speaker of the entry, the result is cached. */
+	UFUNCTION(BlueprintCallable, Category = "History")
+	UArticyObject* GetSpeaker();
+
+private:
+
+	friend UArticyDialogueHistoryComponent;
+
+	/** The sequence number of the entry this item shows. */
+	int64 Sequence = INDEX_NONE;
+
+	TWeakObjectPtr<UArticyObject> CachedNode;
+	TWeakObjectPtr<UArticyObject> CachedSpeaker;
+
+	/** Returns the entry, or nullptr if it was removed from the history. */
+	const FArticyDialogueHistoryEntry* FindEntry() const;
+};
@@ -13,9 +13,29 @@
 class UArticyString;
 class UArticyInt;
 class UArticyBool;
+class UArticyFloat;
+class UArticyEnum;
 class UArticyExpressoScripts;
 struct ExpressoType;
+struct FExpressoLiteral;
 
+/**
+ * The string of an ExpressoType, shared by all copies of the value and freed with the last one.
+ * Names (FName and enum values) and script literals are pooled instead: they live as long as the module and are not reference counted.
+ */
+struct ARTICYRUNTIME_API FExpressoString
+{
+    FString Value;
+    bool bPooled = false;
+    FThreadSafeCounter RefCount;
+};
+
+/**
+ * The value type used by expresso scripts.
+ * A compact tagged union: object references are stored as id and clone id, strings as a shared FExpressoString.
+ * Copying and comparing values never allocates, copying a string value only counts a reference.
+ * Creating a string value from an FString allocates its shared string, script literals and string variables reuse theirs.
+ */
 struct ARTICYRUNTIME_API ExpressoType
 {
     union
@@ -23,33 +43,66 @@ struct ARTICYRUNTIME_API ExpressoType
         bool BoolValue;
         int64 IntValue = 0;
         double FloatValue;
+        /** The id of the referenced object, if Type is ObjectRef. */
+        uint64 ObjectId;
+        /** The shared string, if Type is String. Never null for string values. */
+        FExpressoString* StringValue;
     };
-    FString StringValue;
+    /** The clone id of the referenced object, if Type is ObjectRef. */
+    int32 CloneId = 0;
 
-    enum EType
+    enum EType : uint8
     {
-        Undefined, Bool, Int, Float, String
+        Undefined, Bool, Int, Float, String, ObjectRef
     } Type = Undefined;
 
-    virtual bool& GetBool();
-    virtual const bool& GetBool() const;
+    FORCEINLINE bool& GetBool() { return BoolValue; }
+    FORCEINLINE const bool& GetBool() const { return BoolValue; }
 
-    virtual int64& GetInt();
-    virtual const int64& GetInt() const;
+    FORCEINLINE int64& GetInt() { return IntValue; }
+    FORCEINLINE const int64& GetInt() const { return IntValue; }
 
-    virtual double& GetFloat();
-    virtual const double& GetFloat() const;
+    FORCEINLINE double& GetFloat() { return FloatValue; }
+    FORCEINLINE const double& GetFloat() const { return FloatValue; }
 
-    virtual FString& GetString();
-    virtual const FString& GetString() const;
+    /** Returns the string value, or an empty string if this is not a string. The returned reference is valid as long as this value. */
+    const FString& GetString() const;
 
-    virtual FString ToString() const;
+    /** Returns the referenced object id, or a null id if this is not an object reference. */
+    FArticyId GetObjectId() const { return Type == ObjectRef ? FArticyId{ ObjectId } : FArticyId{}; }
 
+    FString ToString() const;
+
+    /** Returns the pooled string of a name, adding it if it is not pooled yet. Meant for names only, as pooled strings are never freed. */
+    static FExpressoString* InternName(const FName& Name);
+    /** Returns the pooled string of a script literal, see FExpressoLiteral. Like names, literals are a bounded set. */
+    static FExpressoString* InternLiteral(const FString& Literal);
 
     //---------------------------------------------------------------------------//
 
-    ExpressoType();
-    virtual ~ExpressoType();
+    ExpressoType() = default;
+    ExpressoType(const ExpressoType& Other) { CopyFrom(Other); }
+    ExpressoType(ExpressoType&& Other) { FMemory::Memcpy(*this, Other); Other.Type = Undefined; }
+    ExpressoType& operator=(const ExpressoType& Other)
+    {
+        if (this != &Other)
+        {
+            Release();
+            CopyFrom(Other);
+        }
+        return *this;
+    }
+    ExpressoType& operator=(ExpressoType&& Other)
+    {
+        if (this != &Other)
+        {
+            Release();
+            FMemory::Memcpy(*this, Other);
+            Other.Type = Undefined;
+        }
+        return *this;
+    }
+    ~ExpressoType() { Release(); }
 
     //initialize from object and property
     ExpressoType(UArticyBaseObject* Object, const FString& Property);
@@ -69,12 +122,17 @@ struct ARTICYRUNTIME_API ExpressoType
     ExpressoType(const double& Value);
     ExpressoType(const float& Value);
     ExpressoType(const FString& Value);
+    ExpressoType(const FExpressoLiteral& Value);
     ExpressoType(const FText& Value);
     ExpressoType(const FName& Value);
+    /** Object references are stored as id and clone id, a null object is stored as null id. */
     ExpressoType(const UArticyPrimitive* Object);
     ExpressoType(const UArticyString& Value);
     ExpressoType(const UArticyInt& Value);
     ExpressoType(const UArticyBool& Value);
+    ExpressoType(const UArticyFloat& Value);
+    /** Enum variables are converted to the name of their value, like the string variables they replace. */
+    ExpressoType(const UArticyEnum& Value);
     ExpressoType(const FArticyId& Value);
     
     //implicit conversion to value type
@@ -147,6 +205,42 @@ struct ARTICYRUNTIME_API ExpressoType
 
     /** If Property contains a dot, this method modifies Object and Property so a fueature is accessed instead. */
     static UArticyBaseObject* TryFeatureReroute(UArticyBaseObject* Object, FString& Property);
+
+private:
+
+    void SetString(FExpressoString* Value)
+    {
+        Type = String;
+        StringValue = Value;
+    }
+
+    FORCEINLINE void CopyFrom(const ExpressoType& Other)
+    {
+        FMemory::Memcpy(*this, Other);
+        if (Type == String && !StringValue->bPooled)
+            StringValue->RefCount.Increment();
+    }
+
+    FORCEINLINE void Release()
+    {
+        if (Type == String && !StringValue->bPooled && StringValue->RefCount.Decrement() == 0)
+            delete StringValue;
+        Type = Undefined;
+    }
+};
+
+static_assert(sizeof(ExpressoType) == 16, "ExpressoType is expected to fit into 16 bytes.");
+
+/**
+ * A string literal of the generated script fragments, used like an FString.
+ * As a script value it shares its pooled string, so it is only allocated once.
+ */
+struct ARTICYRUNTIME_API FExpressoLiteral : public FString
+{
+    explicit FExpressoLiteral(const TCHAR* Literal);
+
+    /** The pooled string of this literal. */
+    FExpressoString* String;
 };
 
 struct ExpressoType::Definition
@@ -264,6 +358,11 @@ public:
 	 * Note that the passed in condition is only used as a key to look up a lambda in a map of existing (imported) conditions!
 	 */
 	bool Evaluate(const int &ConditionFragmentHash, UArticyGlobalVariables* GV, UObject* MethodProvider) const;
+	/**
+	 * Evaluate many conditions, with the GV instance and method provider only set up once.
+	 * OutResults must have the same number of elements as ConditionFragmentHashes.
+	 */
+	void EvaluateBatch(TArrayView<const int32> ConditionFragmentHashes, UArticyGlobalVariables* GV, UObject* MethodProvider, TArrayView<bool> OutResults) const;
 	/**
 	 * Execute the instruction, and return true (unless the fragment was not found!)
 	 * Note that the passed in condition is only used as a key to look up a lambda in a map of existing (imported) conditions!
@@ -278,6 +377,13 @@ public:
 	UObject* GetDefaultUserMethodsProvider() const;
 	UObject* GetUserMethodsProviderObject() const;
 
+	/**
+	 * Returns the native address of the user methods interface in MethodProvider, or nullptr if it doesn't implement it.
+	 * The address is looked up once per provider, so user methods don't search the interface on every call.
+	 * With bSkipBlueprints, blueprint providers return nullptr, as their methods must be called through Execute_.
+	 */
+	void* GetNativeUserMethodsProvider(UObject* MethodProvider, bool bSkipBlueprints) const;
+
 	/** Gets the active GV instance in use if we're running an expresso script (otherwise nullptr) */
 	virtual UArticyGlobalVariables* GetGV() { return nullptr; }
 
@@ -304,6 +410,13 @@ protected:
 
 	/** Don't change the name, it's called like this in script fragments! */
 	UArticyObject* getObj(const FString& NameOrId, const uint32& CloneId = 0) const;
+	/** Used by generated script fragments instead of getObj calls with literal arguments. */
+	UArticyObject* getObj(const FArticyObjectHandle& Handle) const;
+
+	/** Cached lookups for getObj calls with literal arguments, filled by the generated constructor. */
+	TArray<FArticyObjectHandle> ObjectHandles;
+	/** The string literals of all script fragments, filled by the generated constructor. */
+	TArray<FExpressoLiteral> StringLiterals;
 
 	/** Don't change the name, it's called like this in script fragments! */
 	static void setProp(UArticyBaseObject* Object, const FString& Property, const ExpressoType& Value);
@@ -376,6 +489,11 @@ protected:
 	// Default Methods Provider (fallback if none is set). This is a weak pointer in case it is deleted.
 	TWeakObjectPtr<UObject> DefaultUserMethodsProvider = nullptr;
 
+	// The provider last passed to GetNativeUserMethodsProvider, and its interface address
+	mutable TWeakObjectPtr<UObject> BoundMethodsProvider = nullptr;
+	mutable void* BoundMethodsProviderInterface = nullptr;
+	mutable bool bBoundMethodsProviderIsBlueprint = false;
+
 private:
 	
 	UArticyDatabase* OwningDatabase = nullptr;
@@ -383,16 +501,12 @@ private:
 	UArticyObject* getObjInternal(const ExpressoType& Id_CloneId) const;
 
 	static void PrintInternal(const FString& msg);
+	/** Replaces the {i} placeholders of a print message in a single pass. */
+	static FString FormatMessage(const FString& Msg, const TArray<ExpressoType>& Args);
 };
 
 template <typename ... ArgTypes>
 void UArticyExpressoScripts::print(const FString& Msg, ArgTypes... Args)
 {
-	auto msg = Msg;
-	
-	auto arr = TArray<ExpressoType>{ Args... };
-	for(int i = 0; i < arr.Num(); ++i)
-		msg = msg.Replace(*FString::Printf(TEXT("{%d}"), i), *FString{ arr[i] });
-
-	PrintInternal(msg);
+	PrintInternal(FormatMessage(Msg, TArray<ExpressoType>{ Args... }));
 }
@@ -10,6 +10,7 @@
 #include "ArticyRef.h"
 #include "Components/BillboardComponent.h"
 #include "Containers/Queue.h"
+#include "Engine/StreamableManager.h"
 #include "ArticyFlowPlayer.generated.h"
 
 class IArticyNode;
@@ -65,6 +66,7 @@ class ARTICYRUNTIME_API UArticyFlowPlayer : public UActorComponent
 public:
 
 	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	//---------------------------------------------------------------------------//
 
@@ -151,10 +153,18 @@ public:
 
 	/**
 	 * Get the UserMethodsProvider used for resolving user defined methods.
+	 * If none is set, the flow player, its owner, the owner's components and the default methods provider are searched.
+	 * The result is cached until the provider is set, the number of components of the owner changes, or the component
+	 * found as provider is removed. A component implementing the interface which is added while another one is removed
+	 * is not noticed, call SetUserMethodsProvider with nullptr to search again in that case.
 	 */
 	UFUNCTION(BlueprintPure, Category = "Setup")
 	UObject* GetMethodsProvider() const;
 
+	/** Set the UserMethodsProvider, or clear it to search for one again. */
+	UFUNCTION(BlueprintCallable, Category = "Setup")
+	void SetUserMethodsProvider(UObject* MethodsProvider);
+
 	//---------------------------------------------------------------------------//
 
 	/** Explore branches starting from the current StartOn node. */
@@ -203,6 +213,11 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category = "Flow")
 	bool bDeferBranchEvaluation = false;
 
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnBranchPlayedNative, UArticyFlowPlayer*, const FArticyBranch&);
+
+	/** This native event is broadcast when a branch is played, before its nodes are executed. */
+	FOnBranchPlayedNative& OnBranchPlayed() { return BranchPlayedEvent; }
+
 protected:
 
 	//========================================//
@@ -233,6 +248,18 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Setup")
 	bool bIgnoreInvalidBranches = true;
 
+	/**
+	 * If set, the assets referenced by the cursor and the nodes of the available branches (like speaker images,
+	 * attachments and voice-over) are loaded in the background whenever the player pauses.
+	 * The loads for branches which were not taken are cancelled.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Setup|Prefetch")
+	bool bPrefetchBranchAssets = false;
+
+	/** The maximum number of assets which are prefetched at the same time, nodes closer to the cursor are prefetched first. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Setup|Prefetch", meta = (ClampMin = 0, EditCondition = "bPrefetchBranchAssets"))
+	int32 MaxPrefetchedAssets = 16;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Setup", meta = (ArticyClassRestriction = "ArticyNode"))
 	FArticyRef StartOn;
 
@@ -270,6 +297,8 @@ private:
 	TQueue<FArticyBranch> BranchQueue;
 	FTSTicker::FDelegateHandle TickerHandle;
 
+	FOnBranchPlayedNative BranchPlayedEvent;
+
 private:
 	/**
 	 * Updates the list of available branches.
@@ -292,11 +321,32 @@ private:
 	 */
 	bool FastForwardToPause();
 
+	/** Prefetches the assets of the cursor and the available branches, and cancels all other prefetches. */
+	void UpdatePrefetchedAssets();
+	void CancelPrefetchedAssets();
+
+	/** The running and completed prefetches, by asset path. */
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> PrefetchHandles;
+
 	/** Returns a ptr to the unshadowed object of this node */
 	IArticyFlowObject* GetUnshadowedNode(IArticyFlowObject* Node);
 
 	UArticyDatabase* GetDB() const;
 	UArticyExpressoScripts* GetExpresso() const;
+
+	/** Searches the methods provider, see GetMethodsProvider. */
+	UObject* FindMethodsProvider(UArticyExpressoScripts* ExpressoInstance) const;
+
+	/** The resolved methods provider, and the state it was resolved for. */
+	mutable TWeakObjectPtr<UObject> ResolvedMethodsProvider;
+	mutable TWeakObjectPtr<UObject> ResolvedForUserMethodsProvider;
+	mutable TWeakObjectPtr<UObject> ResolvedForDefaultMethodsProvider;
+	mutable TWeakObjectPtr<UArticyExpressoScripts> ResolvedExpressoInstance;
+	mutable int32 ResolvedForNumComponents = 0;
+	mutable bool bMethodsProviderResolved = false;
+
+	/** The methods provider of the running exploration, resolved once for all of its nodes. */
+	UObject* ActiveMethodsProvider = nullptr;
 };
 
 //---------------------------------------------------------------------------//
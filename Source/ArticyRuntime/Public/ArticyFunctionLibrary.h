@@ -7,6 +7,7 @@
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "ArticyObject.h"
 #include "ArticyFlowPlayer.h"
+#include "ArticyQuery.h"
 #include "ArticyFunctionLibrary.generated.h"
 
 /**
@@ -65,6 +66,10 @@ public:
 	static FArticyGvName ArticyGvName_MakeFromVariableAndNamespace(const FName& Variable, const FName& Namespace);
 
 
+	/** Runs a query over the objects of the database, see FArticyQuery. */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Run Articy Query", DefaultToSelf = "WorldContext"), Category = "Articy")
+	static TArray<UArticyObject*> RunArticyQuery(const FArticyQuery& Query, const UObject* WorldContext);
+
 	/** Gets the last object in a branch. */
 	UFUNCTION(BlueprintPure, meta=(DisplayName = "Get Target"), Category="ArticyBranch")
 	static TScriptInterface<class IArticyFlowObject> GetBranchTarget(UPARAM(ref) const struct FArticyBranch& Branch);
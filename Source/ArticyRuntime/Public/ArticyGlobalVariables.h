@@ -13,30 +13,11 @@
 #endif
 #include "ShadowStateManager.h"
 #include "ArticyExpressoScripts.h"
+#include "ArticyChangeJournal.h"
 #include "ArticyGlobalVariables.generated.h"
 
 class UArticyAlternativeGlobalVariables;
 
-//implicit convertion operator (= getter)
-//ReSharper disable once CppNonExplicitConversionOperator
-#define ARTICY_VARIABLE_ACCESS(T)			\
-	T& operator=(const T &NewValue)			\
-	{										\
-		/*set and return the new value*/	\
-		return Setter<TRemoveReference<decltype(*this)>::Type>(NewValue);		\
-	}										\
-	const T& Get() const					\
-	{										\
-		/*just return the value*/			\
-		return Value;						\
-	}										\
-	operator const T &() const				\
-	{										\
-		/*just return the value*/			\
-		return Get();						\
-	}
-	
-
 class UArticyFlowPlayer;
 class UArticyGlobalVariables;
 class UArticyVariable;
@@ -44,6 +25,7 @@ class UArticyBaseVariableSet;
 struct ExpressoType;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGVChanged, UArticyVariable*, Variable);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGVChangedNative, UArticyVariable*);
 
 /**
  * This struct stores a shadow copy that is restored once the given shadow
@@ -58,6 +40,205 @@ struct ArticyShadowState
 	Type Value;
 };
 
+/**
+ * Describes a value type global variables can have.
+ * Specializations define how the value is converted from an ExpressoType, and which operators
+ * a variable of this type supports. Using an operator which is not supported fails at compile time.
+ */
+template<typename T>
+struct TArticyVariableTraits
+{
+	static constexpr bool bIsArithmetic = false;
+	static constexpr bool bSupportsAppend = false;
+};
+
+template<>
+struct TArticyVariableTraits<bool>
+{
+	static constexpr bool bIsArithmetic = false;
+	static constexpr bool bSupportsAppend = false;
+
+	static bool FromExpresso(const ExpressoType& Value) { return Value.GetBool(); }
+};
+
+template<>
+struct TArticyVariableTraits<int32>
+{
+	static constexpr bool bIsArithmetic = true;
+	static constexpr bool bSupportsAppend = false;
+
+	static int32 FromExpresso(const ExpressoType& Value)
+	{
+		return Value.Type == ExpressoType::Float ? static_cast<int32>(Value.GetFloat()) : static_cast<int32>(Value.GetInt());
+	}
+
+	/** Applies an operator with an ExpressoType operand, using floating point arithmetic if the operand is a float. */
+	template<typename OperatorType>
+	static int32 Apply(const int32& Value, const ExpressoType& Operand, OperatorType Operator)
+	{
+		if (Operand.Type == ExpressoType::Float)
+			return static_cast<int32>(Operator(static_cast<double>(Value), Operand.GetFloat()));
+
+		return Operator(Value, static_cast<int32>(Operand.GetInt()));
+	}
+};
+
+template<>
+struct TArticyVariableTraits<float>
+{
+	static constexpr bool bIsArithmetic = true;
+	static constexpr bool bSupportsAppend = false;
+
+	static float FromExpresso(const ExpressoType& Value)
+	{
+		return Value.Type == ExpressoType::Float ? static_cast<float>(Value.GetFloat()) : static_cast<float>(Value.GetInt());
+	}
+
+	template<typename OperatorType>
+	static float Apply(const float& Value, const ExpressoType& Operand, OperatorType Operator)
+	{
+		const double operand = Operand.Type == ExpressoType::Float ? Operand.GetFloat() : static_cast<double>(Operand.GetInt());
+		return static_cast<float>(Operator(static_cast<double>(Value), operand));
+	}
+};
+
+template<>
+struct TArticyVariableTraits<FString>
+{
+	static constexpr bool bIsArithmetic = false;
+	static constexpr bool bSupportsAppend = true;
+
+	static FString FromExpresso(const ExpressoType& Value)
+	{
+		// an int is used to store a string representation of an articy object
+		if (Value.Type == ExpressoType::Int)
+			return ArticyHelpers::Uint64ToObjectString(Value.GetInt());
+		// object references keep their ARTICYID_CLONEID representation when stored in a string
+		if (Value.Type == ExpressoType::ObjectRef)
+			return Value.ToString();
+
+		return Value.GetString();
+	}
+
+	static FString Append(const FString& Value, const ExpressoType& Operand) { return Value + (Operand.Type == ExpressoType::ObjectRef ? Operand.ToString() : Operand.GetString()); }
+};
+
+/**
+ * Enum variables store the index of their value name. They can be compared and assigned,
+ * but don't support any arithmetic. Names are resolved by UArticyEnum itself.
+ */
+struct FArticyEnumVariableTraits
+{
+	static constexpr bool bIsArithmetic = false;
+	static constexpr bool bSupportsAppend = false;
+
+	static int32 FromExpresso(const ExpressoType& Value) { return static_cast<int32>(Value.GetInt()); }
+};
+
+/**
+ * Value access and operators of a global variable with the value type T.
+ * VariableType is the UArticyVariable subclass deriving from this, it stores the Value and its Shadows.
+ * All operators are resolved at compile time based on the TraitsType, and always go through the
+ * setter, so shadow states, the change events and the change journal are handled correctly.
+ */
+template<typename VariableType, typename T, typename TraitsType = TArticyVariableTraits<T>>
+class TArticyVariable
+{
+public:
+	typedef T UnderlyingType;
+	typedef TraitsType Traits;
+
+	const T& Get() const { return Self().Value; }
+
+	//implicit conversion operator (= getter)
+	//ReSharper disable once CppNonExplicitConversionOperator
+	operator const T&() const { return Get(); }
+
+	T& operator=(const T& NewValue) { return SetValue(NewValue); }
+	T& operator=(const ExpressoType& NewValue) { return SetValue(Traits::FromExpresso(NewValue)); }
+
+	T& operator+=(const T& Operand)
+	{
+		static_assert(Traits::bIsArithmetic || Traits::bSupportsAppend, "This variable type does not support operator+=");
+		return SetValue(Get() + Operand);
+	}
+	T& operator-=(const T& Operand) { AssertArithmetic(); return SetValue(Get() - Operand); }
+	T& operator*=(const T& Operand) { AssertArithmetic(); return SetValue(Get() * Operand); }
+	T& operator/=(const T& Operand) { AssertArithmetic(); return SetValue(Get() / Operand); }
+
+	T& operator+=(const ExpressoType& Operand) { return SetValue(Add(Operand)); }
+	T& operator-=(const ExpressoType& Operand) { AssertArithmetic(); return SetValue(Traits::Apply(Get(), Operand, [](auto A, auto B) { return A - B; })); }
+	T& operator*=(const ExpressoType& Operand) { AssertArithmetic(); return SetValue(Traits::Apply(Get(), Operand, [](auto A, auto B) { return A * B; })); }
+	T& operator/=(const ExpressoType& Operand) { AssertArithmetic(); return SetValue(Traits::Apply(Get(), Operand, [](auto A, auto B) { return A / B; })); }
+
+	T& operator++() { AssertArithmetic(); return SetValue(Get() + 1); }
+	T& operator--() { AssertArithmetic(); return SetValue(Get() - 1); }
+	T operator++(int)
+	{
+		AssertArithmetic();
+		T copy = Get();
+		SetValue(copy + 1);
+		return copy;
+	}
+	T operator--(int)
+	{
+		AssertArithmetic();
+		T copy = Get();
+		SetValue(copy - 1);
+		return copy;
+	}
+
+private:
+	/** The result of an arithmetic operator with OperandType, only valid if the value type is arithmetic. */
+	template<typename OperandType>
+	using TArithmeticResult = typename TEnableIf<Traits::bIsArithmetic && TIsArithmetic<OperandType>::Value, decltype(DeclVal<T>() + DeclVal<OperandType>())>::Type;
+
+	// Arithmetic operators are hidden friends, so they are only found through argument dependent lookup on articy variables.
+
+	template<typename OperandType = T>
+	friend TArithmeticResult<OperandType> operator+(const VariableType& v1, const VariableType& v2) { return v1.Get() + v2.Get(); }
+	template<typename OperandType>
+	friend TArithmeticResult<OperandType> operator+(const OperandType& k, const VariableType& v) { return k + v.Get(); }
+	template<typename OperandType>
+	friend TArithmeticResult<OperandType> operator+(const VariableType& v, const OperandType& k) { return v.Get() + k; }
+
+	template<typename OperandType = T>
+	friend TArithmeticResult<OperandType> operator-(const VariableType& v1, const VariableType& v2) { return v1.Get() - v2.Get(); }
+	template<typename OperandType>
+	friend TArithmeticResult<OperandType> operator-(const OperandType& k, const VariableType& v) { return k - v.Get(); }
+	template<typename OperandType>
+	friend TArithmeticResult<OperandType> operator-(const VariableType& v, const OperandType& k) { return v.Get() - k; }
+
+	template<typename OperandType = T>
+	friend TArithmeticResult<OperandType> operator*(const VariableType& v1, const VariableType& v2) { return v1.Get() * v2.Get(); }
+	template<typename OperandType>
+	friend TArithmeticResult<OperandType> operator*(const OperandType& k, const VariableType& v) { return k * v.Get(); }
+	template<typename OperandType>
+	friend TArithmeticResult<OperandType> operator*(const VariableType& v, const OperandType& k) { return v.Get() * k; }
+
+	template<typename OperandType = T>
+	friend TArithmeticResult<OperandType> operator/(const VariableType& v1, const VariableType& v2) { return v1.Get() / v2.Get(); }
+	template<typename OperandType>
+	friend TArithmeticResult<OperandType> operator/(const OperandType& k, const VariableType& v) { return k / v.Get(); }
+	template<typename OperandType>
+	friend TArithmeticResult<OperandType> operator/(const VariableType& v, const OperandType& k) { return v.Get() / k; }
+
+	const VariableType& Self() const { return static_cast<const VariableType&>(*this); }
+	VariableType& Self() { return static_cast<VariableType&>(*this); }
+
+	T& SetValue(const T& NewValue) { return Self().template Setter<VariableType>(NewValue); }
+
+	static constexpr void AssertArithmetic() { static_assert(Traits::bIsArithmetic, "This variable type does not support arithmetic operators"); }
+
+	T Add(const ExpressoType& Operand) const
+	{
+		static_assert(Traits::bIsArithmetic || Traits::bSupportsAppend, "This variable type does not support operator+=");
+		return AddImpl(Operand, TIntegralConstant<bool, Traits::bSupportsAppend>());
+	}
+	T AddImpl(const ExpressoType& Operand, TIntegralConstant<bool, true>) const { return Traits::Append(Get(), Operand); }
+	T AddImpl(const ExpressoType& Operand, TIntegralConstant<bool, false>) const { return Traits::Apply(Get(), Operand, [](auto A, auto B) { return A + B; }); }
+};
+
 USTRUCT(BlueprintType)
 struct ARTICYRUNTIME_API FArticyGvName
 {
@@ -102,6 +283,9 @@ public:
 	/** Returns the name of this variable in the form Namespace.Variable */
 	const FName& GetGVName() const { return GVName; }
 
+	/** Incremented whenever the value changes, on any shadow level. Used to detect changes without listening to them. */
+	uint32 GetChangeCount() const { return ChangeCount; }
+
 protected:
 	virtual ~UArticyVariable() {}
 
@@ -113,8 +297,24 @@ protected:
 		auto Instance = static_cast<Type*>(this);
 		check(Instance);
 
-		//push the value if we are in a new shadow level now
+		++ChangeCount;
+
 		const auto storeLevel = GetStoreShadowLevel();
+		if(storeLevel == 0)
+		{
+			//fast path: no shadow state is active, so there is nothing to push
+			checkSlow(GetShadowLevel(Instance) == 0);
+
+			RecordChange(Instance->Value, NewValue);
+			Instance->Value = NewValue;
+
+			OnVariableChanged.Broadcast(this);
+			NotifyStoreOfChange();
+
+			return Instance->Value;
+		}
+
+		//push the value if we are in a new shadow level now
 		const auto shadowLevel = GetShadowLevel(Instance);
 		if(storeLevel > shadowLevel)
 		{																						
@@ -128,24 +328,23 @@ protected:
 			//if the global level is different from ShadowLevel, our ShadowLevel is out of sync!
 			ensure(storeLevel == shadowLevel);
 		}
-		
-		Instance->Value = NewValue;															
-		if(storeLevel == 0)
-			OnVariableChanged.Broadcast(this);
 
-		return Instance->Value;
+		return Instance->Value = NewValue;
 	}																							
 
 	template<typename Type>
 	void PopState(Type* Instance)
 	{
 		if(ensure(GetStoreShadowLevel() == GetShadowLevel(Instance)))
+		{
 			Instance->Value = Instance->Shadows.Pop().Value;
+			++ChangeCount;
+		}
 	}
 
 	template<typename Type>
 	static uint32 GetShadowLevel(Type* Instance);
-	uint32 GetStoreShadowLevel() const;
+	FORCEINLINE uint32 GetStoreShadowLevel() const;
 
 	/** The name of this variable in the form Namespace.Variable */
 	UPROPERTY(BlueprintReadOnly, Category = "Articy")
@@ -156,254 +355,237 @@ private:
 	UPROPERTY()
 	UArticyGlobalVariables* Store = nullptr;
 
+	uint32 ChangeCount = 0;
+
 	template<typename Type>
 	void RegisterOnStorePop(Type* Instance);
+
+	/** Forwards a (layer zero) change of this variable to the store's native change event. */
+	void NotifyStoreOfChange();
+
+	/** Records a (layer zero) change in the store's change journal, if it is enabled. */
+	template<typename ValueType>
+	void RecordChange(const ValueType& OldValue, const ValueType& NewValue);
 };
 
 //---------------------------------------------------------------------------//
 
 UCLASS(BlueprintType)
-class ARTICYRUNTIME_API UArticyInt : public UArticyVariable
+class ARTICYRUNTIME_API UArticyInt : public UArticyVariable, public TArticyVariable<UArticyInt, int32>
 {
 	GENERATED_BODY()
 
 public:
-	typedef int UnderlyingType;
+	typedef TArticyVariable<UArticyInt, int32> FVariableAccess;
 
 	friend UArticyVariable;
+	friend FVariableAccess;
 
-public:
-	//void Init(UArticyBaseGlobalVariables* const NewStore, const int& NewValue) { UArticyVariable::Init(NewStore); Set(NewValue); }
-
-	//getter and setter
-	ARTICY_VARIABLE_ACCESS(int)
+	//getter, setter and operators
+	using FVariableAccess::operator=;
 
-	//other operators
-	int& operator+=(const int &Val) { return *this = Value + Val; }
-	int& operator-=(const int &Val) { return *this = Value - Val; }
-	int& operator*=(const int &Val) { return *this = Value * Val; }
-	int& operator/=(const int &Val) { return *this = Value / Val; }
+	/**
+	 * Set the value of this variable.
+	 * This internally calls the setter, so it guarantees that the correct shadow state is used (if any).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "ValueAccess")
+	int Set(int NewValue) { return *this = NewValue; }
 
-	int operator++(int)
-	{
-		int copy = *this;
-		*this = Value + 1;
-		return copy;
-	}
-	int& operator++() { return *this = Value + 1; }
+protected:
+	/** The current value of this variable (i.e. the value of a shadow state, if any is active). */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Articy")
+	int Value = -1;
 
-	int operator--(int)
-	{
-		int copy = *this;
-		*this = Value - 1;
-		return copy;
-	}
-	int& operator--() { return *this = Value - 1; }
+private:
+	TArray<ArticyShadowState<int32>> Shadows;
+};
 
-	int& operator=(const ExpressoType &NewVal)
-	{
-		if (NewVal.Type == ExpressoType::Float)
-			return Value = NewVal.GetFloat();
-		else
-			return Value = NewVal.GetInt();
-	}
+//---------------------------------------------------------------------------//
 
-	int& operator+=(const ExpressoType &Val)
-	{
-		if (Val.Type == ExpressoType::Float)
-			return *this = Value + Val.GetFloat();
-		else
-			return *this = Value + Val.GetInt();
-	}
+UCLASS(BlueprintType)
+class ARTICYRUNTIME_API UArticyBool : public UArticyVariable, public TArticyVariable<UArticyBool, bool>
+{
+	GENERATED_BODY()
 
-	int& operator-=(const ExpressoType &Val)
-	{
-		if (Val.Type == ExpressoType::Float)
-			return *this = Value - Val.GetFloat();
-		else
-			return *this = Value - Val.GetInt();
-	}
+public:
+	typedef TArticyVariable<UArticyBool, bool> FVariableAccess;
 
-	int& operator*=(const ExpressoType &Val)
-	{
-		if (Val.Type == ExpressoType::Float)
-			return *this = Value * Val.GetFloat();
-		else
-			return *this = Value * Val.GetInt();
-	}
+	friend UArticyVariable;
+	friend FVariableAccess;
 
-	int& operator/=(const ExpressoType &Val)
-	{
-		if (Val.Type == ExpressoType::Float)
-			return *this = Value / Val.GetFloat();
-		else
-			return *this = Value / Val.GetInt();
-	}
+	//getter and setter
+	using FVariableAccess::operator=;
 
 	/**
 	 * Set the value of this variable.
 	 * This internally calls the setter, so it guarantees that the correct shadow state is used (if any).
 	 */
 	UFUNCTION(BlueprintCallable, Category = "ValueAccess")
-	int Set(int NewValue) { return *this = NewValue; }
+	bool Set(bool NewValue) { return *this = NewValue; }
 
 protected:
+
 	/** The current value of this variable (i.e. the value of a shadow state, if any is active). */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Articy")
-	int Value = -1;
+	bool Value = false;
 
 private:
-	TArray<ArticyShadowState<int>> Shadows;
+	TArray<ArticyShadowState<bool>> Shadows;
 };
 
 //---------------------------------------------------------------------------//
 
-// Allow arithmetic operations on integers
-
-static int operator+(const UArticyInt& v1, const UArticyInt& v2)
-{
-	return v1.Get() + v2.Get();
-}
-static int operator+(int k, const UArticyInt& v)
-{
-	return k + v.Get();
-}
-static int operator+(const UArticyInt& v, int k)
+UCLASS(BlueprintType)
+class ARTICYRUNTIME_API UArticyString : public UArticyVariable, public TArticyVariable<UArticyString, FString>
 {
-	return v.Get() + k;
-}
+	GENERATED_BODY()
 
-static int operator-(const UArticyInt& v1, const UArticyInt& v2)
-{
-	return v1.Get() - v2.Get();
-}
-static int operator-(int k, const UArticyInt& v)
-{
-	return k - v.Get();
-}
-static int operator-(const UArticyInt& v, int k)
-{
-	return v.Get() + k;
-}
+public:
+	typedef TArticyVariable<UArticyString, FString> FVariableAccess;
 
-static int operator*(const UArticyInt& v1, const UArticyInt& v2)
-{
-	return v1.Get() * v2.Get();
-}
-static int operator*(int k, const UArticyInt& v)
-{
-	return k * v.Get();
-}
-static int operator*(const UArticyInt& v, int k)
-{
-	return v.Get() * k;
-}
+	friend UArticyVariable;
+	friend FVariableAccess;
+	friend ExpressoType;
 
-static int operator/(const UArticyInt& v1, const UArticyInt& v2)
-{
-	return v1.Get() / v2.Get();
-}
-static int operator/(int k, const UArticyInt& v)
-{
-	return k / v.Get();
-}
-static int operator/(const UArticyInt& v, int k)
-{
-	return v.Get() / k;
-}
+	//getter, setter and operators
+	using FVariableAccess::operator=;
+
+	bool operator ==(const FString& text) const { return Value.Equals(text); }
+	bool operator !=(const FString& text) const { return !this->operator==(text); }
+	bool operator ==(const FString&& text) const { return Value.Equals(text); }
+	bool operator !=(const FString&& text) const { return !this->operator==(text); }
+	bool operator ==(const char* const text) const { return Value.Equals(text); }
+	bool operator !=(const char* const text) const { return !this->operator==(text); }
+
+	/**
+	 * Set the value of this variable.
+	 * This internally calls the setter, so it guarantees that the correct shadow state is used (if any).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "ValueAccess")
+	FString Set(FString NewValue) { return *this = NewValue; }
+
+protected:
+	/** The current value of this variable (i.e. the value of a shadow state, if any is active). */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Articy")
+	FString Value;
+
+private:
+	TArray<ArticyShadowState<FString>> Shadows;
+
+	/** The value this variable was last read as by a script, reused while the value doesn't change. */
+	mutable ExpressoType ScriptValue;
+};
 
 //---------------------------------------------------------------------------//
 
 UCLASS(BlueprintType)
-class ARTICYRUNTIME_API UArticyBool : public UArticyVariable
+class ARTICYRUNTIME_API UArticyFloat : public UArticyVariable, public TArticyVariable<UArticyFloat, float>
 {
 	GENERATED_BODY()
 
 public:
-	typedef bool UnderlyingType;
+	typedef TArticyVariable<UArticyFloat, float> FVariableAccess;
 
 	friend UArticyVariable;
+	friend FVariableAccess;
 
-	//void Init(UArticyBaseGlobalVariables* const NewStore, const bool& NewValue) { UArticyVariable::Init(NewStore); Set(NewValue); }
-
-	//getter and setter
-	ARTICY_VARIABLE_ACCESS(bool)
-
-	bool& operator=(const ExpressoType &NewValue)
-	{
-		return Value = NewValue.GetBool();
-	}
+	//getter, setter and operators
+	using FVariableAccess::operator=;
 
 	/**
 	 * Set the value of this variable.
 	 * This internally calls the setter, so it guarantees that the correct shadow state is used (if any).
 	 */
 	UFUNCTION(BlueprintCallable, Category = "ValueAccess")
-	bool Set(bool NewValue) { return *this = NewValue; }
+	float Set(float NewValue) { return *this = NewValue; }
 
 protected:
-
 	/** The current value of this variable (i.e. the value of a shadow state, if any is active). */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Articy")
-	bool Value = false;
+	float Value = 0.f;
 
 private:
-	TArray<ArticyShadowState<bool>> Shadows;
+	TArray<ArticyShadowState<float>> Shadows;
 };
 
 //---------------------------------------------------------------------------//
 
+/**
+ * A variable which can only hold one of a fixed set of named values.
+ * The value is stored as index into the value names, so comparing it is an integer comparison.
+ * String literals used with enum variables in scripts are converted to these indices when the code is generated.
+ */
 UCLASS(BlueprintType)
-class ARTICYRUNTIME_API UArticyString : public UArticyVariable
+class ARTICYRUNTIME_API UArticyEnum : public UArticyVariable, public TArticyVariable<UArticyEnum, int32, FArticyEnumVariableTraits>
 {
 	GENERATED_BODY()
 
 public:
-	typedef FString UnderlyingType;
+	typedef TArticyVariable<UArticyEnum, int32, FArticyEnumVariableTraits> FVariableAccess;
 
 	friend UArticyVariable;
-
-	//void Init(UArticyBaseGlobalVariables* const NewStore, const FString& NewValue) { UArticyVariable::Init(NewStore); Set(NewValue); }
+	friend FVariableAccess;
 
 	//getter and setter
-	ARTICY_VARIABLE_ACCESS(FString)
-
-	//other operators
-	//FString& operator+=(const FString &Val) { return Setter<UArticyString>(Value + Val); }
+	using FVariableAccess::operator=;
 
-	FString& operator+=(const ExpressoType &Val) { return Setter<UArticyString>(Value + Val.GetString()); }
+	/** Sets the value by its name. Unknown names are not assigned, but logged as error. */
+	int32& operator=(const FString& NewName);
+	/** Strings are resolved by name, all other types are used as index. */
+	int32& operator=(const ExpressoType& NewValue);
 
-	FString& operator=(const ExpressoType &NewValue)
+	bool operator ==(const int32& Index) const { return Value == Index; }
+	bool operator !=(const int32& Index) const { return Value != Index; }
+	bool operator ==(const FString& Name) const
 	{
-		if (NewValue.Type == ExpressoType::Int) // used to store a string representation of an articy object
-			return Value = ArticyHelpers::Uint64ToObjectString(NewValue.GetInt());
-		else
-			return Value = NewValue.GetString();
+		// a name which was never registered can't be a value, and must not match the None of an invalid value
+		const int32 index = FindValue(FName(*Name, FNAME_Find));
+		return index != INDEX_NONE && Value == index;
 	}
-
-	bool operator ==(const FString& text) const { return Value.Equals(text); }
-	bool operator !=(const FString& text) const { return !this->operator==(text); }
-	bool operator ==(const FString&& text) const { return Value.Equals(text); }
-	bool operator !=(const FString&& text) const { return !this->operator==(text); }
-	bool operator ==(const char* const text) const { return Value.Equals(text); }
-	bool operator !=(const char* const text) const { return !this->operator==(text); }
+	bool operator !=(const FString& Name) const { return !this->operator==(Name); }
 
 	/**
 	 * Set the value of this variable.
 	 * This internally calls the setter, so it guarantees that the correct shadow state is used (if any).
 	 */
 	UFUNCTION(BlueprintCallable, Category = "ValueAccess")
-	FString Set(FString NewValue) { return *this = NewValue; }
+	int32 Set(int32 NewValue) { return *this = NewValue; }
+
+	/** Set the value of this variable by name, returns false if the name is not a value of this variable. */
+	UFUNCTION(BlueprintCallable, Category = "ValueAccess")
+	bool SetByName(FName NewName);
+
+	/** Returns the name of the current value. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "ValueAccess")
+	FName GetValueName() const { return ValueNames.IsValidIndex(Value) ? ValueNames[Value] : NAME_None; }
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "ValueAccess")
+	const TArray<FName>& GetValueNames() const { return ValueNames; }
+
+	/** Returns the index of the value with the given name, or INDEX_NONE. */
+	int32 FindValue(const FName& Name) const { return ValueNames.IndexOfByKey(Name); }
+
+	/** Called by the generated code before the variable is initialized. */
+	void SetValueNames(TArray<FName>&& InValueNames) { ValueNames = MoveTemp(InValueNames); }
 
 protected:
 	/** The current value of this variable (i.e. the value of a shadow state, if any is active). */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Articy")
-	FString Value;
+	int32 Value = 0;
+
+	/** The names of all values, the value of this variable is an index into this array. */
+	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Articy")
+	TArray<FName> ValueNames;
 
 private:
-	TArray<ArticyShadowState<FString>> Shadows;
+	TArray<ArticyShadowState<int32>> Shadows;
 };
 
+static bool operator==(const int32& Index, const UArticyEnum& Variable) { return Variable == Index; }
+static bool operator!=(const int32& Index, const UArticyEnum& Variable) { return Variable != Index; }
+static bool operator==(const FString& Name, const UArticyEnum& Variable) { return Variable == Name; }
+static bool operator!=(const FString& Name, const UArticyEnum& Variable) { return Variable != Name; }
+
 //---------------------------------------------------------------------------//
 
 UCLASS()
@@ -496,6 +678,9 @@ public:
 	 */
 	static UArticyGlobalVariables* GetRuntimeClone(const UObject* WorldContext, UArticyAlternativeGlobalVariables* GVs);
 
+	/** Creates a new runtime instance of a global variables asset. */
+	static UArticyGlobalVariables* CreateRuntimeInstance(UObject* Outer, UArticyGlobalVariables* Asset, const FName& Name);
+
 	/* Unloads the global variables, which causes that all changes get removed. */
 	UFUNCTION(BlueprintCallable, Category = "Packages")
 	void UnloadGlobalVariables();
@@ -518,6 +703,11 @@ public:
 	const int32& GetIntVariable(FArticyGvName GvName, bool& bSucceeded);
 	UFUNCTION(BlueprintCallable, Category="Getter")
 	const FString& GetStringVariable(FArticyGvName GvName, bool& bSucceeded);
+	UFUNCTION(BlueprintCallable, Category="Getter")
+	const float& GetFloatVariable(FArticyGvName GvName, bool& bSucceeded);
+	/** Returns the value name of an enum variable. */
+	UFUNCTION(BlueprintCallable, Category="Getter")
+	FName GetEnumVariable(FArticyGvName GvName, bool& bSucceeded);
 
 	UFUNCTION(BlueprintCallable, Category="Setter")
 	void SetBoolVariable(FArticyGvName GvName, const bool Value);
@@ -525,12 +715,43 @@ public:
 	void SetIntVariable(FArticyGvName GvName, const int32 Value);
 	UFUNCTION(BlueprintCallable, Category="Setter")
 	void SetStringVariable(FArticyGvName GvName, const FString Value);
+	UFUNCTION(BlueprintCallable, Category="Setter")
+	void SetFloatVariable(FArticyGvName GvName, const float Value);
+	/** Sets an enum variable by value name. */
+	UFUNCTION(BlueprintCallable, Category="Setter")
+	void SetEnumVariable(FArticyGvName GvName, const FName Value);
 
 	UFUNCTION(BlueprintCallable, Category="Debug")
 	void EnableDebugLogging();
 	UFUNCTION(BlueprintCallable, Category="Debug")
 	void DisableDebugLogging();
 
+	/**
+	 * Native event which is broadcast every time any (layer zero) variable of this instance changes.
+	 * Cheaper to bind than the dynamic delegates of every single variable, used by the editor debugger.
+	 */
+	FOnGVChangedNative& OnAnyVariableChanged() { return AnyVariableChangedEvent; }
+
+	/**
+	 * Starts recording all changes of the variables in a ring buffer with the given number of entries.
+	 * Object properties changed by instructions using these variables are recorded as well.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Debug")
+	void EnableChangeJournal(int32 Capacity = 4096);
+	UFUNCTION(BlueprintCallable, Category="Debug")
+	void DisableChangeJournal();
+	/**
+	 * Undoes all recorded changes after the journal entry with the given sequence number.
+	 * Returns the number of changes which were undone.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Debug")
+	int32 RewindChangeJournal(int32 Sequence);
+
+	/** Returns the change journal, or nullptr if it is not enabled. */
+	FArticyChangeJournal* GetChangeJournal() const { return ChangeJournal.Get(); }
+	/** Returns the change journal as shared pointer, so it can be held weakly by tools which outlive it. */
+	TSharedPtr<FArticyChangeJournal> GetSharedChangeJournal() const { return ChangeJournal; }
+
 protected:
 
 	UPROPERTY()
@@ -541,6 +762,13 @@ protected:
 
 private:
 
+	FOnGVChangedNative AnyVariableChangedEvent;
+
+	TSharedPtr<FArticyChangeJournal> ChangeJournal;
+
+	/** Enables the change journal if requested in the plugin settings. */
+	void ApplyChangeJournalSettings();
+
 	static TWeakObjectPtr<UArticyGlobalVariables> Clone;
 
 	// Runtime clones of non-default global variable assets managed by GetRuntimeClone
@@ -577,6 +805,11 @@ void UArticyVariable::Init(UArticyBaseVariableSet* Set, UArticyGlobalVariables*
 	OnVariableChanged.AddDynamic(Set, &UArticyBaseVariableSet::BroadcastOnVariableChanged);
 }
 
+FORCEINLINE uint32 UArticyVariable::GetStoreShadowLevel() const
+{
+	return Store->GetShadowLevel();
+}
+
 template <typename Type>
 uint32 UArticyVariable::GetShadowLevel(Type* Instance)
 {
@@ -593,6 +826,13 @@ void UArticyVariable::RegisterOnStorePop(Type* Instance)
 #endif
 }
 
+template <typename ValueType>
+void UArticyVariable::RecordChange(const ValueType& OldValue, const ValueType& NewValue)
+{
+	if(FArticyChangeJournal* Journal = Store->GetChangeJournal())
+		Journal->RecordVariable(this, OldValue, NewValue);
+}
+
 template <typename ArticyVariableType, typename VariablePayloadType>
 void UArticyGlobalVariables::SetVariableValue(const FName Namespace, const FName Variable, const VariablePayloadType Value)
 {
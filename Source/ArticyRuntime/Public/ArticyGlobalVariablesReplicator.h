@@ -0,0 +1,185 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#if ENGINE_MAJOR_VERSION >= 5 || (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 26)
+#include "Net/Serialization/FastArraySerializer.h"
+#else
+#include "Engine/NetSerialization.h"
+#endif
+#include "ArticyGlobalVariablesReplicator.generated.h"
+
+class UArticyGlobalVariables;
+class UArticyAlternativeGlobalVariables;
+class UArticyVariable;
+class UArticyGlobalVariablesReplicator;
+struct FArticyReplicatedVariableArray;
+
+/**
+ * The value type stored in a replicated variable slot.
+ */
+UENUM()
+enum class EArticyReplicatedVariableType : uint8
+{
+	Bool,
+	Int,
+	String,
+	Float,
+	Enum
+};
+
+/**
+ * A single replicated global variable.
+ * The variable is addressed by the index of its namespace in UArticyGlobalVariables::GetVariableSets and by its
+ * index inside UArticyBaseVariableSet::Variables. Both orders are fixed by the generated code, so server and clients
+ * agree on them without sending any names over the wire.
+ */
+USTRUCT()
+struct ARTICYRUNTIME_API FArticyReplicatedVariable : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	uint16 NamespaceIndex = 0;
+	UPROPERTY()
+	uint16 VariableIndex = 0;
+	UPROPERTY()
+	EArticyReplicatedVariableType Type = EArticyReplicatedVariableType::Int;
+
+	/** Holds the value of bool, int and enum variables. */
+	UPROPERTY()
+	int32 IntValue = 0;
+	/** Holds the value of float variables. */
+	UPROPERTY()
+	float FloatValue = 0.f;
+	/** Holds the value of string variables. */
+	UPROPERTY()
+	FString StringValue;
+
+	/** Copies the current value of Variable into this slot. Returns true if the slot changed. */
+	bool CaptureValue(const UArticyVariable* Variable);
+	/** Writes the value of this slot to Variable. */
+	void ApplyValue(UArticyVariable* Variable) const;
+
+	void PostReplicatedAdd(const FArticyReplicatedVariableArray& InArraySerializer);
+	void PostReplicatedChange(const FArticyReplicatedVariableArray& InArraySerializer);
+};
+
+/**
+ * Fast array of all replicated variable slots.
+ * Only slots which were marked dirty since the last update are sent to the clients.
+ */
+USTRUCT()
+struct ARTICYRUNTIME_API FArticyReplicatedVariableArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	TArray<FArticyReplicatedVariable> Items;
+
+	/** The component owning this array, used by the items to apply received values. */
+	UPROPERTY(NotReplicated)
+	UArticyGlobalVariablesReplicator* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FArticyReplicatedVariable, FArticyReplicatedVariableArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FArticyReplicatedVariableArray> : public TStructOpsTypeTraitsBase2<FArticyReplicatedVariableArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Keeps the global variables of all clients in sync with the server.
+ * Add this component to a replicated actor (e.g. the GameState). The server listens to the OnVariableChanged
+ * delegate of every relevant variable and only sends the slots which actually changed.
+ * Changes made inside a shadow state are never replicated, as they don't broadcast OnVariableChanged.
+ *
+ * Per-namespace relevancy is controlled with ReplicatedNamespaces. To replicate some namespaces to one player only,
+ * add a second replicator to an actor which is only relevant to its owner (e.g. the PlayerState or PlayerController).
+ */
+UCLASS(ClassGroup = (Articy), meta = (BlueprintSpawnableComponent))
+class ARTICYRUNTIME_API UArticyGlobalVariablesReplicator : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UArticyGlobalVariablesReplicator();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Returns the global variables instance which is kept in sync by this component. */
+	UFUNCTION(BlueprintCallable, Category = "Articy")
+	UArticyGlobalVariables* GetGVs() const;
+
+	/**
+	 * Replicates a namespace again, or excludes it from replication. Excluding a namespace never replicates others.
+	 * Only has an effect on the server.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Articy")
+	void SetNamespaceReplicated(FName Namespace, bool bReplicated);
+
+	/** Returns true if the given namespace is replicated by this component. */
+	UFUNCTION(BlueprintCallable, Category = "Articy")
+	bool IsNamespaceReplicated(FName Namespace) const;
+
+	/**
+	 * The namespaces which are replicated by this component.
+	 * If this is empty, all namespaces are replicated, except for the ExcludedNamespaces.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Setup")
+	TArray<FName> ReplicatedNamespaces;
+
+	/** The namespaces which are never replicated by this component, even if they are listed in ReplicatedNamespaces. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Setup")
+	TArray<FName> ExcludedNamespaces;
+
+	/**
+	 * The global variables to replicate, if they differ from the default set.
+	 * Must match the OverrideGV of the flow players which use them.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Setup")
+	UArticyAlternativeGlobalVariables* OverrideGV = nullptr;
+
+private:
+
+	friend struct FArticyReplicatedVariable;
+
+	/** Rebuilds all slots from the current state of the global variables. Server only. */
+	void RebuildSlots();
+	/** Removes all slots and unbinds from all variables. */
+	void ClearSlots();
+
+	/** Called on the client whenever a slot was received. */
+	void OnSlotReceived(const FArticyReplicatedVariable& Slot);
+
+	UFUNCTION()
+	void OnVariableChanged(UArticyVariable* Variable);
+
+	UPROPERTY(Replicated)
+	FArticyReplicatedVariableArray ReplicatedVariables;
+
+	/** Maps a bound variable to the index of its slot in ReplicatedVariables (server only). */
+	TMap<TWeakObjectPtr<UArticyVariable>, int32> SlotByVariable;
+
+	/** The GVs which the slots were built from. */
+	TWeakObjectPtr<UArticyGlobalVariables> BoundGVs;
+};
@@ -0,0 +1,71 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ArticyBaseTypes.h"
+
+enum class EArticyMarkupTokenType : uint8
+{
+	Text,
+	/** <tag> or <tag=value>, the value may be quoted. */
+	OpenTag,
+	/** </tag>, Unreal's </> is not a closing tag in articy markup. */
+	CloseTag
+};
+
+/** A piece of articy (or unity) rich text markup, as found by FArticyMarkupTokenizer. */
+struct ARTICYRUNTIME_API FArticyMarkupToken
+{
+	EArticyMarkupTokenType Type = EArticyMarkupTokenType::Text;
+
+	/** The range of the whole token in the source string. */
+	int32 Start = 0;
+	int32 Length = 0;
+
+	/** The name of a tag, not set for text. */
+	FString Name;
+	/** The value of an opening tag, without quotes. */
+	FString Value;
+
+	bool IsTag() const { return Type != EArticyMarkupTokenType::Text; }
+	bool HasValue() const { return Value.Len() > 0; }
+};
+
+/**
+ * Splits rich text markup into text and tags in a single pass, without regular expressions.
+ * Anything which doesn't form a valid tag, like a single '<', is returned as text.
+ * The tokenizer references the source string, so it must outlive the tokenizer.
+ */
+class ARTICYRUNTIME_API FArticyMarkupTokenizer
+{
+public:
+
+	explicit FArticyMarkupTokenizer(const FString& InSource) : Source(InSource) {}
+
+	/** Reads the next token, returns false once the end of the source is reached. Text tokens are never empty. */
+	bool Next(FArticyMarkupToken& OutToken);
+
+private:
+
+	/** Reads the tag starting with the '<' at Start, returns false if there is no valid tag. */
+	bool ReadTag(const int32 Start, FArticyMarkupToken& OutToken) const;
+
+	const FString& Source;
+	int32 Position = 0;
+
+	/** The tag found after a text token, which is returned next. */
+	FArticyMarkupToken PendingTag;
+	bool bHasPendingTag = false;
+};
+
+namespace ArticyMarkup
+{
+	/** The metadata of a link run which holds the id of the link target, resolved on import. */
+	static const TCHAR* LinkIdMetaData = TEXT("linkid");
+
+	/** Extracts the target id of an articy hyperlink (articy://localhost/view/~/<id>). */
+	ARTICYRUNTIME_API bool ParseLinkTarget(const FString& Link, FArticyId& OutId);
+}
@@ -0,0 +1,50 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** A technical name found by a fuzzy search, with its edit distance to the searched name. */
+struct ARTICYRUNTIME_API FArticyNameMatch
+{
+	FName Name;
+	int32 Distance = 0;
+};
+
+/**
+ * An index of technical names for prefix and fuzzy searches, ignoring case.
+ * The names are stored once, upper case and sorted, so searches never convert the indexed names.
+ * Exact lookups don't need it: FName comparisons already ignore case.
+ */
+class ARTICYRUNTIME_API FArticyNameIndex
+{
+public:
+
+	/** Rebuilds the index from the given names, duplicates and None are skipped. */
+	void Build(const TArray<FName>& Names);
+	void Reset() { Entries.Reset(); }
+
+	int32 Num() const { return Entries.Num(); }
+
+	/** Adds all names starting with Prefix to OutNames, in alphabetical order. MaxResults 0 means no limit. */
+	void FindWithPrefix(const FString& Prefix, TArray<FName>& OutNames, const int32 MaxResults = 0) const;
+
+	/**
+	 * Adds all names within MaxDistance edits (insertions, deletions or substitutions) of Name to OutMatches,
+	 * closest first. MaxResults 0 means no limit.
+	 */
+	void FindFuzzy(const FString& Name, const int32 MaxDistance, TArray<FArticyNameMatch>& OutMatches, const int32 MaxResults = 0) const;
+
+private:
+
+	struct FEntry
+	{
+		FString Key;
+		FName Name;
+	};
+
+	/** Sorted by Key. */
+	TArray<FEntry> Entries;
+};
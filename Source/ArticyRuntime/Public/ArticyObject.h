@@ -19,7 +19,9 @@ class ARTICYRUNTIME_API UArticyObject : public UArticyPrimitive
 	GENERATED_BODY()
 
 public:
-	FName GetTechnicalName() const;
+	/** The technical name, interned when the object is imported, so this never converts the name. */
+	const FName& GetTechnicalName() const { return InternedTechnicalName; }
+	const FString& GetTechnicalNameString() const { return TechnicalName; }
 
 	UFUNCTION(BlueprintCallable, Category = "Articy")
 	UArticyObject* GetParent() const;
@@ -55,7 +57,15 @@ protected:
 	/** Used internally by ArticyImporter. */
 	void InitFromJson(TSharedPtr<FJsonValue> Json) override;
 
+	virtual void PostLoad() override;
+
 private:
 
+	/** TechnicalName as FName, set together with it. */
+	UPROPERTY()
+	FName InternedTechnicalName;
+
 	mutable TArray<TWeakObjectPtr<UArticyObject>> CachedChildren;
+	/** The object lookup generation of the database the children were cached with. */
+	mutable uint32 CachedChildrenGeneration = 0;
 };
@@ -3,11 +3,18 @@
 #include "CoreMinimal.h"
 #include "ArticyObject.h"
 #include "UObject/UObjectHash.h"
+#include "Engine/DataAsset.h"
 #include "ArticyPackage.generated.h"
 
 
+/**
+ * A package exported from articy, containing its objects as sub-objects.
+ * Packages are primary assets of the type "ArticyPackage", with the bundle "Media" containing the unreal assets
+ * referenced by the articy assets and objects of the package. To cook packages into separate chunks,
+ * add the ArticyPackage type to the primary asset types of the asset manager settings, and assign the chunks in its rules.
+ */
 UCLASS(BlueprintType)
-class ARTICYRUNTIME_API UArticyPackage : public UDataAsset
+class ARTICYRUNTIME_API UArticyPackage : public UPrimaryDataAsset
 {
 	GENERATED_BODY()
 
@@ -21,9 +28,19 @@ protected:
 
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "Articy")
 	TMap<FArticyId, TSoftObjectPtr<UArticyObject>> AssetsById;
+
+	/** The unreal assets referenced by this package, gathered on import. */
+	UPROPERTY(VisibleAnywhere, Category = "Articy", meta = (AssetBundles = "Media"))
+	TArray<FSoftObjectPath> MediaAssets;
 public: 
 
-	virtual FPrimaryAssetId GetPrimaryAssetId() const override { return FPrimaryAssetId(FName(TEXT("ArticyPackage")), GetFName()); }
+	static FPrimaryAssetType GetPrimaryAssetType() { return FName(TEXT("ArticyPackage")); }
+	static FName GetMediaBundleName() { return FName(TEXT("Media")); }
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override { return FPrimaryAssetId(GetPrimaryAssetType(), GetFName()); }
+
+	void SetMediaAssets(const TArray<FSoftObjectPath>& InMediaAssets) { MediaAssets = InMediaAssets; }
+	const TArray<FSoftObjectPath>& GetMediaAssets() const { return MediaAssets; }
 
 	void AddAsset(UArticyObject* ArticyObject);
 
@@ -33,11 +50,9 @@ public:
 	UFUNCTION()
 	void Clear();
 
-	UFUNCTION()
-	const TArray<UArticyObject*> GetAssets();
+	const TArray<UArticyObject*>& GetAssets() const;
 
-	UFUNCTION()
-	const TMap<FName, TSoftObjectPtr<UArticyObject>> GetAssetsDict();
+	const TMap<FName, TSoftObjectPtr<UArticyObject>>& GetAssetsDict() const;
 
 	UFUNCTION()
 	UArticyObject* GetAssetById(const FArticyId& Id) const;
@@ -71,14 +86,15 @@ inline void UArticyPackage::Clear()
 	Assets.Empty();
 	AssetsById.Empty();
 	AssetsByTechnicalName.Empty();
+	MediaAssets.Empty();
 }
 
-inline const TArray<UArticyObject*> UArticyPackage::GetAssets()
+inline const TArray<UArticyObject*>& UArticyPackage::GetAssets() const
 {
 	return Assets;
 }
 
-inline const TMap<FName, TSoftObjectPtr<UArticyObject>> UArticyPackage::GetAssetsDict()
+inline const TMap<FName, TSoftObjectPtr<UArticyObject>>& UArticyPackage::GetAssetsDict() const
 {
 	return AssetsByTechnicalName;
 }
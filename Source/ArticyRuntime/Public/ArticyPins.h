@@ -40,12 +40,19 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Articy")
 	UArticyObject* GetOwner();
 
+	//returns a cached hash of the script fragment (Text)
+	int GetTextHash() const;
+
 	//---------------------------------------------------------------------------//
 
 	EArticyPausableType GetType() override { return EArticyPausableType::Pin; }
 
 	//stub implementation
 	void Explore(UArticyFlowPlayer* Player, TArray<FArticyBranch>& OutBranches, const uint32& Depth) override { ensure(false); }
+
+private:
+
+	mutable int CachedTextHash = 0;
 };
 
 /**
@@ -63,6 +70,7 @@ public:
 	//---------------------------------------------------------------------------//
 
 	bool Evaluate(class UArticyGlobalVariables* GV = nullptr, class UObject* MethodProvider = nullptr) override;
+	bool GetConditionHash(int32& OutHash) const override;
 
 	void Explore(UArticyFlowPlayer* Player, TArray<FArticyBranch>& OutBranches, const uint32& Depth) override;
 };
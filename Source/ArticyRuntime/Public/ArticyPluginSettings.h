@@ -10,6 +10,39 @@
 #include "Runtime/Launch/Resources/Version.h"
 #include "ArticyPluginSettings.generated.h"
 
+UENUM()
+enum class EArticyGlobalVariableStorage : uint8
+{
+	/** Stores the variable as UArticyFloat. Works for integer and string variables containing a number. */
+	Float,
+	/** Stores a string variable as UArticyEnum, i.e. as index into a fixed list of values. */
+	Enum
+};
+
+/**
+ * Changes the type a global variable is generated with.
+ * articy:draft only knows bool, int and string variables, which are sometimes used to emulate floats and enums.
+ */
+USTRUCT()
+struct ARTICYRUNTIME_API FArticyGlobalVariableTypeOverride
+{
+	GENERATED_BODY()
+
+	/** The full name of the variable, in the form Namespace.Variable */
+	UPROPERTY(EditAnywhere, Category=ImportSettings)
+	FString Variable;
+
+	UPROPERTY(EditAnywhere, Category=ImportSettings)
+	EArticyGlobalVariableStorage Storage = EArticyGlobalVariableStorage::Float;
+
+	/**
+	 * All values of an enum variable. String literals assigned to or compared with the variable in scripts are
+	 * replaced by the index of the value when the code is generated. The default value is added if it is missing.
+	 */
+	UPROPERTY(EditAnywhere, Category=ImportSettings, meta=(EditCondition="Storage == EArticyGlobalVariableStorage::Enum"))
+	TArray<FString> EnumValues;
+};
+
 UCLASS(config = Engine, defaultconfig)
 class ARTICYRUNTIME_API UArticyPluginSettings : public UObject
 {
@@ -48,6 +81,17 @@ public:
 	 */
 	UPROPERTY(VisibleAnywhere, config, Category = ImportSettings, meta = (DisplayName = "Articy Directory", ContentDir, LongPackageName))
 	FDirectoryPath ArticyDirectory;
+
+	/**
+	 * Writes the localized texts of the imported objects into the string table asset ArticyTexts, instead of storing them in each object.
+	 * The objects then only reference their texts by key. The text keys don't change, so existing translations remain valid.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = ImportSettings, meta = (DisplayName = "Export texts to string table"))
+	bool bExportTextsToStringTable;
+
+	/** Generates the listed global variables as native float or enum variables. Changes require a complete reimport. */
+	UPROPERTY(EditAnywhere, config, Category = ImportSettings, meta = (DisplayName = "Global variable type overrides"))
+	TArray<FArticyGlobalVariableTypeOverride> GlobalVariableTypeOverrides;
 	
 	/** Keeps one instance of the database for the whole game alive, even if the world changes */
 	UPROPERTY(EditAnywhere, config, Category=RuntimeSettings, meta=(DisplayName="Keep database between worlds"))
@@ -61,6 +105,14 @@ public:
 	UPROPERTY(EditAnywhere, config, Category=RuntimeSettings, meta=(DisplayName="Convert Unity formatting to Unreal Rich Text"))
 	bool bConvertUnityToUnrealRichText;
 
+	/** Records all changes of the runtime global variables in a change journal, which can be inspected and rewound. Never active in shipping builds. */
+	UPROPERTY(EditAnywhere, config, Category=RuntimeSettings, meta=(DisplayName="Record change journal"))
+	bool bRecordChangeJournal;
+
+	/** The number of changes kept in the change journal before the oldest ones get overwritten */
+	UPROPERTY(EditAnywhere, config, Category=RuntimeSettings, meta=(DisplayName="Change journal capacity", ClampMin=1, EditCondition="bRecordChangeJournal"))
+	int32 ChangeJournalCapacity;
+
 
 	// internal cached data for data consistency between imports (setting restoration etc.)
 	UPROPERTY()
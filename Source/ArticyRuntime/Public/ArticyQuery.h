@@ -0,0 +1,181 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "ArticyObject.h"
+#include "ArticyQuery.generated.h"
+
+class UArticyDatabase;
+class UArticyCloneableObject;
+
+UENUM(BlueprintType)
+enum class EArticyQueryOperator : uint8
+{
+	Equal,
+	NotEqual,
+	Less,
+	LessOrEqual,
+	Greater,
+	GreaterOrEqual,
+	/** Only matches text properties. */
+	StartsWith,
+	/** Only matches text properties. */
+	Contains
+};
+
+/** Compares a property of the queried objects with a value. */
+USTRUCT(BlueprintType)
+struct ARTICYRUNTIME_API FArticyQueryCondition
+{
+	GENERATED_BODY()
+
+	/** The name of the property, properties of features are accessed with a dot, like "Item.Rarity". */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	FString Property;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	EArticyQueryOperator Operator = EArticyQueryOperator::Equal;
+
+	/** The value to compare with, it is converted to the type of the property. Ids can be written as hex (0x...) or decimal. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	FString Value;
+};
+
+/**
+ * A query over the loaded objects of a database, which runs against the indexes of the database.
+ * In C++ it is built with the builder methods:
+ *
+ *   auto items = FArticyQuery().OfClass<UItem>().UnderParent(FolderId)
+ *       .Where(TEXT("Item.Rarity"), EArticyQueryOperator::Greater, 3)
+ *       .SortBy(TEXT("DisplayName")).Page(0, 20).Execute(DB);
+ *
+ * In blueprints, use the Make node and the Run Articy Query (Async) nodes.
+ */
+USTRUCT(BlueprintType)
+struct ARTICYRUNTIME_API FArticyQuery
+{
+	GENERATED_BODY()
+
+	/** Only objects of this class or a subclass. Templates are generated classes, so this also filters by template. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	TSubclassOf<UArticyObject> ObjectClass;
+
+	/** Only objects which have this feature, i.e. implement the generated feature interface. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	TSubclassOf<UInterface> Feature;
+
+	/** Only children of this object, unless it is null. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	FArticyId Parent;
+
+	/** If true, all descendants of Parent match, not only its direct children. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	bool bIncludeSubtree = true;
+
+	/** Only objects whose technical name starts with this prefix (ignoring case). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	FString NamePrefix;
+
+	/** All of these conditions must be met, they are checked in order. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	TArray<FArticyQueryCondition> Conditions;
+
+	/** The property to sort the result by. If empty, the result is in index order. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	FString SortProperty;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	bool bSortDescending = false;
+
+	/** The number of matching objects to skip. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	int32 Offset = 0;
+
+	/** The maximum number of objects to return, 0 returns all. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy")
+	int32 Limit = 0;
+
+	/** The clone of the matching objects which is returned. Delta clones of the candidates are materialized. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Articy", AdvancedDisplay)
+	int32 CloneId = 0;
+
+	//========================================//
+
+	FArticyQuery& OfClass(TSubclassOf<UArticyObject> InClass) { ObjectClass = InClass; return *this; }
+	template<typename T>
+	FArticyQuery& OfClass() { return OfClass(T::StaticClass()); }
+
+	FArticyQuery& WithFeature(TSubclassOf<UInterface> InFeature) { Feature = InFeature; return *this; }
+	template<typename T>
+	FArticyQuery& WithFeature() { return WithFeature(T::UClassType::StaticClass()); }
+
+	FArticyQuery& UnderParent(const FArticyId& InParent, const bool bInIncludeSubtree = true) { Parent = InParent; bIncludeSubtree = bInIncludeSubtree; return *this; }
+	FArticyQuery& WithNamePrefix(const FString& Prefix) { NamePrefix = Prefix; return *this; }
+
+	FArticyQuery& Where(const FString& Property, const EArticyQueryOperator Operator, const FString& Value);
+	FArticyQuery& Where(const FString& Property, const EArticyQueryOperator Operator, const TCHAR* Value) { return Where(Property, Operator, FString(Value)); }
+	template<typename T>
+	FArticyQuery& Where(const FString& Property, const EArticyQueryOperator Operator, const T& Value) { return Where(Property, Operator, LexToString(Value)); }
+	/** Adds a custom predicate. Predicates are evaluated on the game thread, after all other conditions and before paging. */
+	FArticyQuery& Where(TFunction<bool(const UArticyObject*)> Predicate);
+
+	FArticyQuery& SortBy(const FString& Property, const bool bDescending = false) { SortProperty = Property; bSortDescending = bDescending; return *this; }
+	FArticyQuery& Page(const int32 InOffset, const int32 InLimit) { Offset = InOffset; Limit = InLimit; return *this; }
+	FArticyQuery& WithCloneId(const int32 InCloneId) { CloneId = InCloneId; return *this; }
+
+	//========================================//
+
+	/** Runs the query. Stops as soon as the requested page is full, unless the result is sorted. */
+	TArray<UArticyObject*> Execute(const UArticyDatabase* Database) const;
+
+	/**
+	 * Runs the query on a worker thread, and calls OnCompleted on the game thread.
+	 * The game thread copies the candidates from the indexes, then takes a snapshot of their ids and compared
+	 * property values in slices of a few milliseconds per frame. The conditions, sorting and paging are evaluated
+	 * on that snapshot by the worker thread, the predicates run on the game thread when the result is looked up.
+	 */
+	void ExecuteAsync(UArticyDatabase* Database, TFunction<void(const TArray<UArticyObject*>&)> OnCompleted) const;
+
+private:
+
+	/** The state of ExecuteAsync, while it is taking the snapshot and evaluating it. */
+	struct FAsyncState;
+
+	/** Calls Visitor for every candidate container from the most selective index, until it returns false. */
+	void ForEachCandidateContainer(const UArticyDatabase* Database, TFunctionRef<bool(UArticyCloneableObject*)> Visitor) const;
+	/** Calls Visitor for every candidate from the most selective index, until it returns false. */
+	void ForEachCandidate(const UArticyDatabase* Database, TFunctionRef<bool(UArticyObject*)> Visitor) const;
+	/** Checks class, feature and name prefix, but not the property conditions or predicates. */
+	bool MatchesObject(const UArticyObject* Object) const;
+	bool MatchesPredicates(const UArticyObject* Object) const;
+
+	TArray<TFunction<bool(const UArticyObject*)>> Predicates;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnArticyQueryCompleted, const TArray<UArticyObject*>&, Objects);
+
+/** Runs an articy query on a worker thread, see FArticyQuery::ExecuteAsync. */
+UCLASS()
+class ARTICYRUNTIME_API UArticyQueryAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintAssignable)
+	FOnArticyQueryCompleted OnCompleted;
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContext", DisplayName = "Run Articy Query Async"), Category = "Articy")
+	static UArticyQueryAsyncAction* RunArticyQueryAsync(const UObject* WorldContext, const FArticyQuery& Query);
+
+	virtual void Activate() override;
+
+private:
+
+	FArticyQuery Query;
+	TWeakObjectPtr<UArticyDatabase> Database;
+};
@@ -14,6 +14,7 @@
 #include "Framework/Text/ITextDecorator.h"
 #include "Components/RichTextBlockDecorator.h"
 #include "Engine/DataTable.h"
+#include "ArticyBaseTypes.h"
 #include "ArticyRichTextDecorator.generated.h"
 
 class UArticyObject;
@@ -33,6 +34,9 @@ public:
     // Callback when a link is navigated
 	void OnArticyLinkNavigated(URichTextBlock* Parent, const FString Link);
 
+    // Callback when a link is navigated, with the target already resolved from the link
+	void OnArticyLinkTargetNavigated(URichTextBlock* Parent, FArticyId Target);
+
     // Used to find the hyperlink handler parent of a rich text block
     UObject* GetHyperlinkHandler(URichTextBlock* RichTextBlock);
 
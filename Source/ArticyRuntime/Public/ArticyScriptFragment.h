@@ -19,14 +19,14 @@ class ARTICYRUNTIME_API UArticyScriptFragment : public UArticyPrimitive
 	GENERATED_BODY()
 public:
 	const FString& GetExpression() const { return Expression; }
+
+	//returns a cached hash of the expression
+	int GetExpressionHash() const;
 protected:
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Articy")
 	FString Expression = "";
 
-	//returns a cached hash of the expression
-	int GetExpressionHash() const;
-
 	template<typename Type, typename PropType>
 		friend struct ArticyObjectTypeInfo;
 
@@ -50,6 +50,7 @@ class ARTICYRUNTIME_API UArticyScriptCondition : public UArticyScriptFragment, p
 public:
 
 	bool Evaluate(class UArticyGlobalVariables* GV = nullptr, class UObject* MethodProvider = nullptr) override;
+	bool GetConditionHash(int32& OutHash) const override;
 };
 
 /**
@@ -67,6 +68,7 @@ public:
 	EArticyPausableType GetType() override { return EArticyPausableType::Condition; }
 
 	bool Evaluate(class UArticyGlobalVariables* GV = nullptr, class UObject* MethodProvider = nullptr) override;
+	bool GetConditionHash(int32& OutHash) const override;
 
 	void Explore(UArticyFlowPlayer* Player, TArray<FArticyBranch>& OutBranches, const uint32& Depth) override;
 
@@ -0,0 +1,107 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "ArticyRef.h"
+#include "ArticySubsystem.generated.h"
+
+class UArticyDatabase;
+class UArticyGlobalVariables;
+class UArticyAlternativeGlobalVariables;
+
+DECLARE_DYNAMIC_DELEGATE(FOnArticyDialoguePrewarmed);
+
+/** The runtime instances belonging to one world, or to the whole game instance. */
+USTRUCT()
+struct FArticyRuntimeInstances
+{
+	GENERATED_BODY()
+
+	/** The world these instances belong to, null for the instances kept between worlds. */
+	TWeakObjectPtr<UWorld> World;
+
+	UPROPERTY()
+	UArticyDatabase* Database = nullptr;
+
+	UPROPERTY()
+	UArticyGlobalVariables* GlobalVariables = nullptr;
+
+	/** Runtime clones of alternative global variable sets, by the full name of the asset. */
+	UPROPERTY()
+	TMap<FName, UArticyGlobalVariables*> RuntimeGlobalVariables;
+};
+
+/**
+ * Owns the runtime instances of the articy database and global variables of a game instance.
+ * Depending on the "keep between worlds" plugin settings, there is one instance for the whole game instance,
+ * or one per world which is released when the world is cleaned up.
+ * Instances kept between worlds are created when the game instance starts, the others on first use,
+ * or ahead of time by calling WarmUp, e.g. while a loading screen is shown.
+ */
+UCLASS()
+class ARTICYRUNTIME_API UArticySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Returns the subsystem of the game instance of the context's world, or nullptr if there is none (e.g. in editor worlds). */
+	static UArticySubsystem* Get(const UObject* WorldContext);
+
+	UArticyDatabase* GetDatabase(UWorld* World);
+	UArticyGlobalVariables* GetGlobalVariables(UWorld* World);
+	UArticyGlobalVariables* GetRuntimeGlobalVariables(UWorld* World, UArticyAlternativeGlobalVariables* Asset);
+
+	/** Creates the database and global variables of the context's world now, if they don't exist yet, and loads the default packages. */
+	UFUNCTION(BlueprintCallable, Category = "Articy", meta = (WorldContext = "WorldContext"))
+	void WarmUp(const UObject* WorldContext);
+
+	/**
+	 * Prepares the dialogues starting at the given nodes, so they play without hitches: warms up the database,
+	 * resolves the pins, connections and scripts of all nodes reachable within Depth hops (0 only prepares the start nodes),
+	 * and loads the assets these nodes and their speakers reference (preview images, attachments, asset slots) in the background.
+	 * OnAssetsLoaded is called once all assets are loaded, they stay loaded until ReleasePrewarmedAssets is called,
+	 * or until they are replaced by the assets of another call for the same start nodes.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Articy", meta = (WorldContext = "WorldContext", AutoCreateRefTerm = "OnAssetsLoaded"))
+	void PrewarmDialogue(const UObject* WorldContext, const TArray<FArticyRef>& StartNodes, int32 Depth, const FOnArticyDialoguePrewarmed& OnAssetsLoaded);
+
+	/** Allows the assets loaded by PrewarmDialogue to be garbage collected again, once nothing else uses them. */
+	UFUNCTION(BlueprintCallable, Category = "Articy")
+	void ReleasePrewarmedAssets();
+
+	/** Forgets an instance, so it is created again from the asset when it is used next. Returns false if it isn't owned by this subsystem. */
+	bool ReleaseDatabase(UArticyDatabase* Database);
+	bool ReleaseGlobalVariables(UArticyGlobalVariables* GlobalVariables);
+
+private:
+
+	FArticyRuntimeInstances& GetInstances(UWorld* World, const bool bKeepBetweenWorlds);
+
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	UPROPERTY(Transient)
+	FArticyRuntimeInstances PersistentInstances;
+
+	/** Usually there is only a single world, so this is searched linearly. */
+	UPROPERTY(Transient)
+	TArray<FArticyRuntimeInstances> WorldInstances;
+
+	/** The plugin settings, read once when the game instance starts. */
+	bool bKeepDatabaseBetweenWorlds = false;
+	bool bKeepGlobalVariablesBetweenWorlds = false;
+
+	FDelegateHandle WorldCleanupHandle;
+
+	FStreamableManager StreamableManager;
+	/** Keeps the assets loaded by PrewarmDialogue in memory, by the start node they were loaded for. */
+	TMap<FArticyId, TSharedPtr<FStreamableHandle>> PrewarmHandles;
+};
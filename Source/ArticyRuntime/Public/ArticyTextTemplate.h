@@ -0,0 +1,101 @@
+//  
+// Copyright (c) articy Software GmbH & Co. KG. All rights reserved.  
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UArticyDatabase;
+class UArticyVariable;
+class UArticyGlobalVariables;
+
+/**
+ * A text with embedded tokens, which are replaced by their current values when it is rendered:
+ *
+ *   "You have {Inventory.Gold} gold, and your sword deals {Sword.Weapon.Damage} damage."
+ *
+ * A token is either a global variable (Namespace.Variable) or a property of an object (TechnicalName.Property,
+ * properties of features are accessed with a dot). Tokens which cannot be resolved are kept as they are.
+ *
+ * The text is parsed once into literal segments and tokens, and variables are resolved to handles on the first render.
+ * Tokens are resolved again whenever objects were loaded or unloaded, until then unresolved tokens are treated as literals.
+ * The result is rendered into a buffer owned by the template, which is only rendered again if one of the referenced
+ * variables changed. Object properties have no change notification, so templates with object tokens are always rendered.
+ */
+class ARTICYRUNTIME_API FArticyTextTemplate
+{
+public:
+
+	FArticyTextTemplate() = default;
+	explicit FArticyTextTemplate(const FString& InSource) { Parse(InSource); }
+
+	/** Splits the source into segments, the tokens are resolved on the next render. */
+	void Parse(const FString& InSource);
+
+	const FString& GetSource() const { return Source; }
+	/** Returns false if the source has no tokens, so rendering it returns the source. */
+	bool HasTokens() const { return Tokens.Num() > 0; }
+
+	/**
+	 * Renders the template with the current values. The returned string is valid until the template is rendered or parsed again.
+	 * If bOutChanged is given, it is set to false if the previous result was returned.
+	 */
+	const FString& Render(const UArticyDatabase* Database, bool* bOutChanged = nullptr);
+
+	/** Resolves all tokens again on the next render. */
+	void Invalidate();
+
+private:
+
+	struct FSegment
+	{
+		/** The range of a literal or token in the source, including the braces of a token. */
+		int32 Start = 0;
+		int32 Length = 0;
+		/** The index of the token, or INDEX_NONE for literals. */
+		int32 Token = INDEX_NONE;
+	};
+
+	struct FToken
+	{
+		/** The variable namespace or technical name of the object, before the first dot. */
+		FName Scope;
+		/** The variable or property name, after the first dot. */
+		FString Name;
+
+		TWeakObjectPtr<UArticyVariable> Variable;
+		/** The change count of the variable when the template was last rendered. */
+		uint32 RenderedChangeCount = 0;
+		/** Whether the token is a property of a loaded object. If it is neither this nor a variable, it is a literal. */
+		bool bObject = false;
+	};
+
+	/** Looks up the variables of all tokens in the GVs of the database, and the objects of the other tokens. */
+	void Resolve(const UArticyDatabase* Database);
+	/** Returns true if a referenced variable changed since the last render. */
+	bool NeedsRender() const;
+	/** Appends the current value of a token, returns false if it could not be resolved. */
+	bool AppendValue(const UArticyDatabase* Database, FToken& Token);
+
+	FString Source;
+	TArray<FSegment> Segments;
+	TArray<FToken> Tokens;
+
+	FString Buffer;
+	bool bResolved = false;
+	bool bHasObjectTokens = false;
+
+	/** The GVs the variable handles were resolved against. */
+	TWeakObjectPtr<UArticyGlobalVariables> ResolvedGVs;
+	/** The object lookup generation of the database when the object tokens were resolved. */
+	uint32 ResolvedObjectGeneration = 0;
+};
+
+/** A text template together with the text it rendered, as cached by the database for every formatted object text. */
+struct FArticyFormattedText
+{
+	FArticyTextTemplate Template;
+	FText Text;
+};
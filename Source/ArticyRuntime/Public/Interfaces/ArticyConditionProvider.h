@@ -22,6 +22,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Condition", meta=(AdvancedDisplay="GV, MethodProvider"))
 	virtual bool Evaluate(class UArticyGlobalVariables* GV = nullptr, class UObject* MethodProvider = nullptr) { return true; }
 
+	/**
+	 * Gets the hash the condition script is registered with in the expresso scripts, so it can be evaluated in a batch.
+	 * Returns false if the condition has no script, Evaluate is called instead then.
+	 */
+	virtual bool GetConditionHash(int32& OutHash) const { return false; }
+
 	/*virtual bool Execute(class UArticyGlobalVariables* GV = nullptr, class UObject* MethodProvider = nullptr)
 	{
 		//evaluate condition and return result
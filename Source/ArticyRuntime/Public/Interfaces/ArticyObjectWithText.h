@@ -34,6 +34,15 @@ public:
 	
 	//---------------------------------------------------------------------------//
 
+	/**
+	 * Returns the text with its global variable and object property tokens, like {Inventory.Gold},
+	 * replaced by their current values. See UArticyDatabase::GetFormattedText.
+	 */
+	UFUNCTION(BlueprintCallable, Category="ArticyObjectWithText", meta=(WorldContext="WorldContext"))
+	virtual FText GetFormattedText(const UObject* WorldContext) const;
+
+	//---------------------------------------------------------------------------//
+
 	UFUNCTION(BlueprintCallable, Category="ArticyObjectWithText")
 	virtual FText& SetText(UPARAM(ref) const FText& Text)
 	{